@@ -0,0 +1,126 @@
+#include "../include/curl_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Request latency through CurlPool against a fresh easy handle per request.
+// A pooled handle finds its connection alive and skips the TCP connect and
+// TLS handshake; a fresh handle pays for both, unless it shares the pool's
+// TLS session cache, which turns the full handshake into a resumption.
+//
+//   ./curl_pool_bench URL [requests] [CA_FILE]
+//
+// Point it at a local HTTPS endpoint that keeps connections alive and
+// answers POSTs, so the network does not drown the handshake; CA_FILE
+// verifies a self-signed certificate (e.g. https://localhost:8443/...).
+
+namespace {
+
+const std::string kBody = R"({"jsonrpc":"2.0","id":1,"method":"public/test","params":{}})";
+
+size_t discard(void*, size_t size, size_t nmemb, void*) {
+    return size * nmemb;
+}
+
+struct Target {
+    std::string url;
+    std::string ca_file;  // empty: the system store
+};
+
+bool post(CURL* curl, const Target& target, curl_slist* headers) {
+    curl_easy_setopt(curl, CURLOPT_URL, target.url.c_str());
+    curl_easy_setopt(curl, CURLOPT_POST, 1L);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, kBody.data());
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(kBody.size()));
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, discard);
+    if (!target.ca_file.empty()) {
+        curl_easy_setopt(curl, CURLOPT_CAINFO, target.ca_file.c_str());
+    }
+    CURLcode res = curl_easy_perform(curl);
+    if (res != CURLE_OK) {
+        std::fprintf(stderr, "request failed: %s\n", curl_easy_strerror(res));
+        return false;
+    }
+    return true;
+}
+
+// Microseconds per request, sorted; empty if a request failed
+template <typename F>
+std::vector<double> measure(int requests, F&& request) {
+    std::vector<double> micros;
+    micros.reserve(static_cast<size_t>(requests));
+    for (int i = 0; i < requests; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        if (!request()) {
+            return {};
+        }
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        micros.push_back(elapsed.count());
+    }
+    std::sort(micros.begin(), micros.end());
+    return micros;
+}
+
+void report(const char* name, const std::vector<double>& micros) {
+    if (micros.empty()) {
+        std::printf("%-28s failed\n", name);
+        return;
+    }
+    auto at = [&](double q) { return micros[static_cast<size_t>(q * static_cast<double>(micros.size() - 1))]; };
+    std::printf("%-28s p50 %8.1f us   p90 %8.1f us   p99 %8.1f us\n", name, at(0.5), at(0.9), at(0.99));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s URL [requests] [CA_FILE]\n", argv[0]);
+        return 2;
+    }
+    Target target{argv[1], argc > 3 ? argv[3] : ""};
+    int requests = argc > 2 ? std::stoi(argv[2]) : 1000;
+
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    curl_slist* headers = curl_slist_append(nullptr, "Content-Type: application/json");
+
+    // What API does: lease, send, give back
+    CurlPool pool;
+    if (!post(pool.acquire(target.url).get(), target, headers)) {  // opens the connection
+        return 1;
+    }
+    std::vector<double> pooled = measure(requests, [&] {
+        CurlPool::Handle curl = pool.acquire(target.url);
+        return curl && post(curl.get(), target, headers);
+    });
+
+    // Keeps no idle handles: a new handle per request, but sharing the pool's
+    // TLS session cache, so every handshake after the first is a resumption
+    CurlPool no_idle(0);
+    std::vector<double> resumed = measure(requests, [&] {
+        CurlPool::Handle curl = no_idle.acquire(target.url);
+        return curl && post(curl.get(), target, headers);
+    });
+
+    // The old way: curl_easy_init / perform / cleanup
+    std::vector<double> fresh = measure(requests, [&] {
+        CURL* curl = curl_easy_init();
+        if (!curl) {
+            return false;
+        }
+        bool ok = post(curl, target, headers);
+        curl_easy_cleanup(curl);
+        return ok;
+    });
+
+    std::printf("%s, %d requests each\n", target.url.c_str(), requests);
+    report("pooled handle", pooled);
+    report("fresh handle, shared cache", resumed);
+    report("fresh handle", fresh);
+
+    curl_slist_free_all(headers);
+    curl_global_cleanup();
+    return pooled.empty() || fresh.empty() ? 1 : 0;
+}
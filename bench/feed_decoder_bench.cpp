@@ -0,0 +1,125 @@
+#include "../include/feed_decoder.h"
+#include "../include/json_index.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+// Decode throughput of FeedDecoder against building a json DOM for the same
+// frames, and what the two tokenizers cost on them before any field is
+// converted: a bare JsonScanner pass (what FeedDecoder rides on) against
+// building a JsonIndex and walking every value through it. Notifications
+// are read almost entirely, so a decoder over the index pays for both
+// passes without skipping much.
+// Run a Release build: ./feed_decoder_bench [iterations]
+
+namespace {
+
+const std::string kBook =
+    R"({"jsonrpc":"2.0","method":"subscription","params":{"channel":"book.BTC-PERPETUAL.raw","data":{"type":"change",)"
+    R"("timestamp":1700000000123,"prev_change_id":68870123,"instrument_name":"BTC-PERPETUAL","change_id":68870124,)"
+    R"("bids":[["change",36950.5,12340.0],["delete",36949.0,0.0],["new",36948.5,500.0]],)"
+    R"("asks":[["new",36951.0,20.0],["change",36952.5,9810.0]]}}})";
+
+const std::string kTrades =
+    R"({"jsonrpc":"2.0","method":"subscription","params":{"channel":"trades.BTC-PERPETUAL.raw","data":[)"
+    R"({"trade_seq":30289432,"trade_id":"48079254","timestamp":1590484156350,"tick_direction":0,"price":8950.0,)"
+    R"("mark_price":8948.9,"instrument_name":"BTC-PERPETUAL","index_price":8955.88,"direction":"sell","amount":10.0},)"
+    R"({"trade_seq":30289433,"trade_id":"48079255","timestamp":1590484156350,"tick_direction":1,"price":8950.5,)"
+    R"("mark_price":8948.9,"instrument_name":"BTC-PERPETUAL","index_price":8955.88,"direction":"buy","amount":20.0}]}})";
+
+const std::string kTicker =
+    R"({"jsonrpc":"2.0","method":"subscription","params":{"channel":"ticker.BTC-PERPETUAL.raw","data":{)"
+    R"("timestamp":1623060194301,"stats":{"volume_usd":1,"volume":2,"price_change":3,"low":1,"high":2},"state":"open",)"
+    R"("settlement_price":36000.0,"open_interest":5,"min_price":3,"max_price":4,"mark_price":36922.42,)"
+    R"("last_price":36923.5,"instrument_name":"BTC-PERPETUAL","index_price":36919.07,"funding_8h":0.0001,)"
+    R"("current_funding":0,"best_bid_price":36923.0,"best_bid_amount":4800.0,"best_ask_price":36923.5,)"
+    R"("best_ask_amount":320.0}}})";
+
+// Counts events and nothing else
+struct NullHandler {
+    size_t events = 0;
+
+    bool start_object() { ++events; return true; }
+    bool end_object() { ++events; return true; }
+    bool start_array() { ++events; return true; }
+    bool end_array() { ++events; return true; }
+    bool key(std::string_view) { ++events; return true; }
+    bool string(std::string_view) { ++events; return true; }
+    bool number(std::string_view, bool) { ++events; return true; }
+    bool boolean(bool) { ++events; return true; }
+    bool null() { ++events; return true; }
+};
+
+// The same events read back from a JsonIndex: every member and element,
+// with the text of every scalar
+size_t walk(const JsonIndex& index, size_t i) {
+    size_t events = 1;
+    char c = index.first_char(i);
+    if (c == '{') {
+        index.for_each_member(i, [&](std::string_view, size_t value) {
+            events += 1 + walk(index, value);
+            return true;
+        });
+    } else if (c == '[') {
+        index.for_each_element(i, [&](size_t element) {
+            events += walk(index, element);
+            return true;
+        });
+    } else {
+        events += index.value_text(i).size() != 0;
+    }
+    return events;
+}
+
+template <typename F>
+double ns_per_call(int iterations, F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        f();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+void run(const char* name, const std::string& frame, int iterations) {
+    FeedDecoder decoder;
+    Notification notification;
+    size_t sink = 0;
+    double decode = ns_per_call(iterations, [&] {
+        decoder.decode(frame, notification);
+        sink += notification.book.bids.size() + notification.trade_count;
+    });
+    JsonScanner scanner;
+    NullHandler handler;
+    double scan = ns_per_call(iterations, [&] {
+        scanner.parse(frame, handler);
+    });
+    sink += handler.events;
+    JsonIndex index;
+    double build = ns_per_call(iterations, [&] {
+        index.build(frame);
+        sink += index.size();
+    });
+    double index_walk = ns_per_call(iterations, [&] {
+        index.build(frame);
+        sink += walk(index, 0);
+    });
+    double dom = ns_per_call(iterations, [&] {
+        json parsed = json::parse(frame);
+        sink += parsed["params"]["data"].size();
+    });
+    std::printf("%-8s FeedDecoder %7.1f ns   json DOM %8.1f ns\n", name, decode, dom);
+    std::printf("%-8s JsonScanner pass %7.1f ns   JsonIndex build %7.1f ns, build + walk %7.1f ns   (%zu)\n", "",
+                scan, build, index_walk, sink % 10);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::stoi(argv[1]) : 200000;
+    run("book", kBook, iterations);
+    run("trades", kTrades, iterations);
+    run("ticker", kTicker, iterations);
+    return 0;
+}
@@ -0,0 +1,245 @@
+#include "../include/event_recorder.h"
+#include "../include/price_ladder.h"
+#include "../include/websocket_client.h"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// Applying book deltas to a PriceLadder per side against a std::map per
+// side, reading the top of book after every message as a strategy would.
+//
+//   ./order_book_bench                      synthetic BTC-PERPETUAL-like deltas
+//   ./order_book_bench FILE                 replay a recording (event_recorder.h)
+//   ./order_book_bench record FILE SECONDS [HOST PORT PATH]
+//                                           record book.BTC-PERPETUAL.raw first
+
+namespace {
+
+constexpr double kTickSize = 0.5;  // BTC-PERPETUAL
+
+struct LevelOp {
+    bool bid;
+    int64_t tick;
+    double amount;  // 0 deletes the level
+};
+
+struct Message {
+    bool snapshot;
+    size_t first;  // ops [first, last)
+    size_t last;
+};
+
+struct Feed {
+    std::vector<LevelOp> ops;
+    std::vector<Message> messages;
+};
+
+bool load_feed(const std::string& path, Feed& feed) {
+    EventBuffer events;
+    if (!load_recording(path, events)) {
+        return false;
+    }
+    FixedScale tick = FixedScale::from_double(kTickSize);
+    events.for_each([&](const EventHeader& header) {
+        if (header.type != EventType::Book) {
+            return;
+        }
+        const BookRecord& record = event_cast<BookRecord>(header);
+        Message message{(header.flags & BookRecord::kSnapshot) != 0, feed.ops.size(), 0};
+        for (uint32_t i = 0; i < header.count; ++i) {
+            const BookLevelRecord& level = record.levels()[i];
+            double amount = level.action == BookLevelUpdate::Action::Delete
+                ? 0.0 : to_double(Decimal{level.amount_mantissa, level.amount_scale});
+            feed.ops.push_back({i < record.bid_count,
+                                tick.to_units_nearest(Decimal{level.price_mantissa, level.price_scale}), amount});
+        }
+        message.last = feed.ops.size();
+        feed.messages.push_back(message);
+    });
+    return !feed.messages.empty();
+}
+
+// A snapshot of 800 levels a side around 60000, then deltas of one to three
+// levels, mostly near the touch, with the mid wandering a few ticks at a time
+Feed synthetic_feed(size_t messages) {
+    Feed feed;
+    std::mt19937_64 rng(42);
+    int64_t mid = 120000;  // ticks
+    feed.messages.push_back({true, 0, 0});
+    for (int64_t i = 1; i <= 800; ++i) {
+        feed.ops.push_back({true, mid - i, static_cast<double>(10 * (1 + rng() % 1000))});
+        feed.ops.push_back({false, mid + i, static_cast<double>(10 * (1 + rng() % 1000))});
+    }
+    feed.messages.back().last = feed.ops.size();
+
+    std::geometric_distribution<int> depth(0.1);
+    for (size_t m = 0; m < messages; ++m) {
+        if (rng() % 20 == 0) {
+            mid += static_cast<int64_t>(rng() % 7) - 3;
+        }
+        Message message{false, feed.ops.size(), 0};
+        for (int n = 1 + static_cast<int>(rng() % 3); n > 0; --n) {
+            bool bid = rng() & 1;
+            int64_t offset = 1 + depth(rng);
+            double amount = rng() % 10 < 3 ? 0.0 : static_cast<double>(10 * (1 + rng() % 1000));
+            feed.ops.push_back({bid, bid ? mid - offset : mid + offset, amount});
+        }
+        message.last = feed.ops.size();
+        feed.messages.push_back(message);
+    }
+    return feed;
+}
+
+class LadderBook {
+public:
+    void clear() {
+        bids_.clear();
+        asks_.clear();
+    }
+    void set(const LevelOp& op) { (op.bid ? bids_ : asks_).set(Price(op.tick), op.amount); }
+    int64_t top() const {
+        return (bids_.empty() ? 0 : bids_.best_price().units) + (asks_.empty() ? 0 : asks_.best_price().units);
+    }
+    std::vector<std::pair<int64_t, double>> levels(bool bid, size_t depth) const {
+        std::vector<std::pair<int64_t, double>> out;
+        (bid ? bids_ : asks_).for_each([&](Price price, double amount) {
+            out.emplace_back(price.units, amount);
+            return out.size() < depth;
+        });
+        return out;
+    }
+
+private:
+    PriceLadder bids_{PriceLadder::Side::Bid};
+    PriceLadder asks_{PriceLadder::Side::Ask};
+};
+
+class MapBook {
+public:
+    void clear() {
+        bids_.clear();
+        asks_.clear();
+    }
+    void set(const LevelOp& op) {
+        if (op.bid) {
+            apply(bids_, op);
+        } else {
+            apply(asks_, op);
+        }
+    }
+    int64_t top() const {
+        return (bids_.empty() ? 0 : bids_.begin()->first) + (asks_.empty() ? 0 : asks_.begin()->first);
+    }
+    std::vector<std::pair<int64_t, double>> levels(bool bid, size_t depth) const {
+        std::vector<std::pair<int64_t, double>> out;
+        auto copy = [&](const auto& side) {
+            for (auto it = side.begin(); it != side.end() && out.size() < depth; ++it) {
+                out.emplace_back(it->first, it->second);
+            }
+        };
+        if (bid) {
+            copy(bids_);
+        } else {
+            copy(asks_);
+        }
+        return out;
+    }
+
+private:
+    template <typename Side>
+    static void apply(Side& side, const LevelOp& op) {
+        if (op.amount == 0.0) {
+            side.erase(op.tick);
+        } else {
+            side[op.tick] = op.amount;
+        }
+    }
+
+    std::map<int64_t, double, std::greater<int64_t>> bids_;
+    std::map<int64_t, double> asks_;
+};
+
+template <typename Book>
+double ns_per_message(const Feed& feed, Book& book, int64_t& sink) {
+    auto start = std::chrono::steady_clock::now();
+    for (const Message& message : feed.messages) {
+        if (message.snapshot) {
+            book.clear();
+        }
+        for (size_t i = message.first; i < message.last; ++i) {
+            book.set(feed.ops[i]);
+        }
+        sink += book.top();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(feed.messages.size());
+}
+
+int record(const std::string& path, int seconds, const std::string& host, const std::string& port,
+           const std::string& target) {
+    io_context ioc;
+    WebSocketClient ws(ioc);
+    EventRecorder recorder(path);
+    if (!recorder.is_open()) {
+        return 1;
+    }
+    size_t messages = 0;
+    try {
+        ws.connect(host, port, target);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "cannot connect to %s:%s: %s\n", host.c_str(), port.c_str(), e.what());
+        return 1;
+    }
+    ws.subscribe_events({"book.BTC-PERPETUAL.raw"}, [&](const EventBuffer& events) {
+        recorder.write(events);
+        ++messages;
+    });
+    ioc.run_for(std::chrono::seconds(seconds));
+    recorder.flush();
+    std::printf("recorded %zu book messages to %s\n", messages, path.c_str());
+    return messages > 0 ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "record") {
+        if (argc < 4) {
+            std::fprintf(stderr, "usage: %s record FILE SECONDS [HOST PORT PATH]\n", argv[0]);
+            return 2;
+        }
+        return record(argv[2], std::stoi(argv[3]), argc > 4 ? argv[4] : "www.deribit.com",
+                      argc > 5 ? argv[5] : "80", argc > 6 ? argv[6] : "/ws/api/v2");
+    }
+
+    Feed feed;
+    if (argc > 1) {
+        if (!load_feed(argv[1], feed)) {
+            std::fprintf(stderr, "no book messages in %s\n", argv[1]);
+            return 1;
+        }
+        std::printf("%s: ", argv[1]);
+    } else {
+        feed = synthetic_feed(2000000);
+        std::printf("synthetic: ");
+    }
+    std::printf("%zu messages, %zu level updates\n", feed.messages.size(), feed.ops.size());
+
+    int64_t sink = 0;
+    LadderBook ladder;
+    MapBook map;
+    for (int round = 0; round < 3; ++round) {
+        double ladder_ns = ns_per_message(feed, ladder, sink);
+        double map_ns = ns_per_message(feed, map, sink);
+        std::printf("ladder %6.1f ns/message   std::map %6.1f ns/message\n", ladder_ns, map_ns);
+    }
+
+    // Both books saw the same feed and must agree
+    bool same = ladder.levels(true, 50) == map.levels(true, 50) && ladder.levels(false, 50) == map.levels(false, 50);
+    std::printf("top 50 levels %s\n", same ? "agree" : "DIFFER");
+    return same && sink != 0 ? 0 : 1;
+}
@@ -0,0 +1,59 @@
+#include "../include/price_ladder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+// PriceLadder::sweep() and depth_within() against walking the levels one by
+// one with for_each, on a dense ask ladder. ./price_ladder_bench [iterations]
+
+namespace {
+
+double walk_sweep(const PriceLadder& ladder, double amount) {
+    double filled = 0.0;
+    double notional = 0.0;
+    ladder.for_each([&](Price price, double size) {
+        double take = std::min(size, amount - filled);
+        filled += take;
+        notional += take * static_cast<double>(price.units);
+        return filled < amount;
+    });
+    return notional;
+}
+
+template <typename F>
+double ns_per_call(int iterations, F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        f(i);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::stoi(argv[1]) : 1000000;
+
+    PriceLadder asks(PriceLadder::Side::Ask, 4096);
+    for (int64_t i = 0; i < 4000; ++i) {
+        asks.set(Price(200000 + i), static_cast<double>(1 + i % 7));
+    }
+
+    double sink = 0.0;
+    for (int levels : {100, 1000, 3000}) {
+        // The amount that fills exactly 'levels' levels
+        double amount = 0.0;
+        asks.for_each([&](Price price, double size) {
+            amount += size;
+            return price.units < 200000 + levels - 1;
+        });
+        double sweep = ns_per_call(iterations, [&](int i) { sink += asks.sweep(amount - (i & 1)).tick_notional; });
+        double walk = ns_per_call(iterations / 10, [&](int i) { sink += walk_sweep(asks, amount - (i & 1)); });
+        double depth = ns_per_call(iterations, [&](int i) { sink += asks.depth_within(levels - (i & 1)); });
+        std::printf("%4d levels: sweep %7.1f ns (for_each walk %8.1f ns)   depth_within %7.1f ns\n", levels, sweep,
+                    walk, depth);
+    }
+    return sink == 0.0;
+}
@@ -0,0 +1,111 @@
+#include "../include/order_book.h"
+#include "../include/seqlock.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Publishing BookSnapshots through a SeqLock against a mutex-guarded copy:
+// one writer applies a 10-level delta per update and publishes, while
+// readers copy the latest snapshot. ./seqlock_bench [seconds] [readers]
+
+namespace {
+
+class MutexBox {
+public:
+    void store(const BookSnapshot& snapshot) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        snapshot_ = snapshot;
+    }
+    BookSnapshot load() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return snapshot_;
+    }
+
+private:
+    std::mutex mutex_;
+    BookSnapshot snapshot_;
+};
+
+class SeqLockBox {
+public:
+    void store(const BookSnapshot& snapshot) { lock_.store(snapshot); }
+    BookSnapshot load() { return lock_.load(); }
+
+private:
+    SeqLock<BookSnapshot> lock_;
+};
+
+BookUpdate levels(int64_t change_id, int count, int64_t amount) {
+    BookUpdate update;
+    update.snapshot = true;
+    update.change_id = change_id;
+    for (int i = 0; i < count; ++i) {
+        update.bids.push_back({BookLevelUpdate::Action::New, Decimal{650000 - 5 * i, 1}, Decimal{amount, 0}});
+        update.asks.push_back({BookLevelUpdate::Action::New, Decimal{650010 + 5 * i, 1}, Decimal{amount, 0}});
+    }
+    return update;
+}
+
+template <typename Box>
+void run(const char* name, int readers, double seconds) {
+    Box box;
+    OrderBook book("BTC-PERPETUAL", FixedScale::from_double(0.5));
+    book.apply(levels(0, 50, 100));
+
+    std::atomic<bool> stop{false};
+    std::atomic<long> reads{0};
+    std::atomic<long> torn{0};
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&] {
+            long n = 0;
+            long bad = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                BookSnapshot snapshot = box.load();
+                // Every level amount is written as the change id
+                for (uint32_t i = 0; i < snapshot.bid_count; ++i) {
+                    bad += snapshot.bids[i].amount != static_cast<double>(snapshot.change_id);
+                }
+                ++n;
+            }
+            reads += n;
+            torn += bad;
+        });
+    }
+
+    long writes = 0;
+    double publish_ns = 0.0;
+    auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+    while (std::chrono::steady_clock::now() < end) {
+        ++writes;
+        book.apply(levels(writes, 10, writes));
+        auto start = std::chrono::steady_clock::now();
+        BookSnapshot snapshot;
+        book.fill_snapshot(snapshot);
+        box.store(snapshot);
+        publish_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+    stop = true;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    std::printf("%-8s %d readers: publish %6.0f ns avg (%ld updates), reads %6.1f M/s total, torn %ld\n", name,
+                readers, publish_ns / writes, writes, reads / seconds / 1e6, torn.load());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? std::stod(argv[1]) : 2.0;
+    int readers = argc > 2 ? std::stoi(argv[2]) : 8;
+    std::printf("snapshot %zu bytes\n", sizeof(BookSnapshot));
+    for (int n : {0, readers}) {
+        run<SeqLockBox>("seqlock", n, seconds);
+        run<MutexBox>("mutex", n, seconds);
+    }
+    return 0;
+}
@@ -1,8 +1,20 @@
 #ifndef API_H
 #define API_H
 
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 #include "../include/json.hpp"  // ✅ Include JSON library
+#include "arena_json.h"
+#include "curl_pool.h"
+#include "deribit_schema.h"
+#include "instrument_registry.h"
+#include "json_index.h"
+#include "json_view.h"
+#include "order_grids.h"
+#include "rate_limiter.h"
+#include "rpc_encoder.h"
 
 using json = nlohmann::json; // ✅ Define 'json' globally
 
@@ -11,16 +23,75 @@ public:
     API(const std::string& client_id, const std::string& client_secret);
     
     std::string authenticate();
+    // ✅ Price and amount are snapped to the instrument's tick size and
+    // minimum trade amount (loaded once per instrument, see get_instrument)
     std::string place_order(const std::string& access_token, const std::string& instrument, int amount, const std::string& type, double price);
-    json cancel_order(const std::string& access_token, const std::string& order_id);  // ✅ Now 'json' is recognized
-    json send_post_request(const std::string& url, const json& data, const std::string& access_token);
-    json modify_order(const std::string& access_token, const std::string& order_id, int new_amount, double new_price);
-    json get_order_book(const std::string& instrument_name);
-    json get_current_positions(const std::string& access_token);
+    std::string place_order(const std::string& access_token, InstrumentId instrument, int amount, const std::string& type, double price);
+
+    // ✅ Typed results, decoded straight from the response bytes (see
+    // deribit_schema.h); empty when the request failed, after the error
+    // has been printed
+    std::optional<Order> cancel_order(const std::string& access_token, const std::string& order_id);
+    // ✅ The new price and amount are snapped to the order's instrument,
+    // which is looked up first with get_order_state()
+    std::optional<OrderPlacement> modify_order(const std::string& access_token, const std::string& order_id, int new_amount, double new_price);
+    // Same, snapping to the grid of 'instrument' without the lookup
+    std::optional<OrderPlacement> modify_order(const std::string& access_token, const std::string& order_id, InstrumentId instrument, bool buy, int new_amount, double new_price);
+    std::optional<Order> get_order_state(const std::string& access_token, const std::string& order_id);
+    std::optional<OrderBookSnapshot> get_order_book(const std::string& instrument_name);
+    std::optional<OrderBookSnapshot> get_order_book(InstrumentId instrument);
+    // ✅ Lazy alternative: the "result" object, indexed but not decoded, so
+    // only the fields read through the view are converted. It points into
+    // this API's last response and is valid until the next request.
+    std::optional<JsonView> get_order_book_view(const std::string& instrument_name, int depth = 10);
+    std::optional<Ticker> get_ticker(const std::string& instrument_name);
+    // public/get_instrument; also records the instrument's order grid
+    std::optional<InstrumentSpec> get_instrument(const std::string& instrument_name);
+    std::optional<std::vector<Position>> get_current_positions(const std::string& access_token);
+
+    // Generic requests: the parsed response, or {"error": ...}. The tree
+    // lives in this API's response arena and stays valid until the next
+    // send_post_request(); copy out what must outlive it.
+    const ArenaJson& send_post_request(const std::string& url, const json& data, const std::string& access_token);
+    // A JSON-RPC 'method' without a typed schema (e.g. private/get_account_summary),
+    // sent through send_post_request(); same lifetime
+    const ArenaJson& call(const std::string& method, const json& params, const std::string& access_token);
+    // The raw response body; transport failures come back as a JSON-RPC error
+    std::string send_raw_request(const std::string& url, std::string_view body, const std::string& access_token);
+
+    // Opens pooled connections ahead of the first order
+    void warm_up(size_t connections = 1);
+
+    // Credit buckets every request is paced through; share it with an
+    // AsyncAPI on the same account so both spend from one budget
+    RateLimiter& rate_limiter() { return limiter; }
+
+    // Grids recorded by get_instrument(); give it to an AsyncAPI or
+    // OrderGateway so their orders are snapped the same way
+    const OrderGrids& order_grids() const { return grids; }
 
 private:
+    std::string perform_request(const std::string& url, std::string_view body, const std::string& access_token);
+
+    // Decodes the result of 'body' into 'result', printing any error under 'what'
+    template <typename T>
+    bool decode_result(std::string_view body, T& result, const char* what);
+    // Grid of 'instrument', fetched with get_instrument() on first use;
+    // empty when it could not be loaded (orders then go out unsnapped)
+    std::optional<OrderGrid> order_grid(InstrumentId instrument);
+    // Keeps 'body' and returns a view of its result, printing any error under 'what'
+    std::optional<JsonView> view_result(std::string body, const char* what);
+
     std::string client_id;
     std::string client_secret;
+    CurlPool pool;  // ✅ Reused handles: no TCP/TLS handshake per request
+    RpcEncoder encoder;  // ✅ Order bodies are written into its buffer, no json tree
+    OrderGrids grids;  // ✅ Tick size and amount step by InstrumentId
+    RateLimiter limiter;  // ✅ Waits for credits locally instead of getting too_many_requests
+    JsonIndex response_index;  // ✅ Reused for every response, keeps its capacity
+    std::string view_body;  // text behind the last JsonView handed out
+    ResponseArena response_arena;  // ✅ Generic responses are parsed here, reset per request
+    ArenaJson response;  // declared after the arena so it is destroyed first
 };
 
 #endif
@@ -0,0 +1,85 @@
+#ifndef ARENA_JSON_H
+#define ARENA_JSON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "json.hpp"
+
+// Arena-backed JSON for parsed REST responses.
+// While a ResponseArena::Scope is active on a thread, every node and string
+// of an ArenaJson built on that thread comes from the arena's monotonic
+// buffer: allocation is a pointer bump, freeing is a no-op, and reset()
+// drops the whole tree at once. No global heap lock is taken, so threads
+// parsing responses into their own arenas do not contend.
+//
+// nlohmann::basic_json default-constructs its allocators, so ArenaAllocator
+// cannot carry the arena; it reads the thread's current resource instead and
+// tags each block with it, so a block is always returned to the resource it
+// came from. Values built outside a scope use the global heap.
+// An ArenaJson must not be used or destroyed after its arena is reset.
+class ResponseArena {
+public:
+    explicit ResponseArena(size_t initial_bytes = 64 * 1024);
+
+    ResponseArena(const ResponseArena&) = delete;
+    ResponseArena& operator=(const ResponseArena&) = delete;
+
+    // Frees everything allocated since the last reset; the initial buffer
+    // is kept and reused
+    void reset() { resource_.release(); }
+
+    std::pmr::memory_resource* resource() { return &resource_; }
+
+    // Makes 'arena' the current resource of the calling thread
+    class Scope {
+    public:
+        explicit Scope(ResponseArena& arena);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        std::pmr::memory_resource* previous_;
+    };
+
+private:
+    std::unique_ptr<std::byte[]> buffer_;
+    std::pmr::monotonic_buffer_resource resource_;
+};
+
+namespace arena_detail {
+void* allocate(size_t bytes);
+void deallocate(void* p, size_t bytes) noexcept;
+}  // namespace arena_detail
+
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    ArenaAllocator() noexcept = default;
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not supported");
+        return static_cast<T*>(arena_detail::allocate(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) noexcept { arena_detail::deallocate(p, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>&) const noexcept { return false; }
+};
+
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+using ArenaJson = nlohmann::basic_json<std::map, std::vector, ArenaString, bool, std::int64_t,
+                                       std::uint64_t, double, ArenaAllocator>;
+
+#endif
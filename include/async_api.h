@@ -0,0 +1,116 @@
+#ifndef ASYNC_API_H
+#define ASYNC_API_H
+
+#include <curl/curl.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "json.hpp"
+#include "instrument_registry.h"
+#include "order_grids.h"
+#include "rate_limiter.h"
+
+using json = nlohmann::json;
+
+// Non-blocking REST engine on top of curl_multi.
+// All transfers are driven by a single event thread, so many orders can be in
+// flight at once without a thread per request. Completions are delivered as a
+// std::future<json> or through a callback that runs on the event thread;
+// the json has the same shape as API::send_post_request's return value.
+//
+// Requests only start when the RateLimiter has credits for them. Until then
+// they wait on the event thread in priority order (cancels, edits, new
+// orders, everything else), registered as waiters with the limiter, so a
+// queued cancel also holds back the edits and orders of API, OrderGateway or
+// another AsyncAPI sharing it. A queued edit is replaced by a newer edit of
+// the same order or dropped by a cancel of it; the dropped request completes
+// with an error saying what superseded it.
+//
+// Given an OrderGrids table (API::order_grids()), orders and edits of
+// instruments with a recorded grid are snapped to it like API's; an amount
+// that snaps to zero completes with an error without being sent.
+class AsyncAPI {
+public:
+    using Callback = std::function<void(json)>;
+
+    AsyncAPI();
+    explicit AsyncAPI(RateLimiter& limiter);  // shares the credit budget with another client
+    AsyncAPI(RateLimiter& limiter, const OrderGrids& grids);  // and the order grids
+    ~AsyncAPI();
+
+    AsyncAPI(const AsyncAPI&) = delete;
+    AsyncAPI& operator=(const AsyncAPI&) = delete;
+
+    std::future<json> send_post_request(const std::string& url, const json& data, const std::string& access_token);
+    void send_post_request(const std::string& url, const json& data, const std::string& access_token, Callback on_done);
+    void send_raw_request(const std::string& url, std::string_view body, const std::string& access_token, Callback on_done);
+
+    std::future<json> place_order(const std::string& access_token, const std::string& instrument, int amount, const std::string& type, double price);
+    void place_order(const std::string& access_token, const std::string& instrument, int amount, const std::string& type, double price, Callback on_done);
+
+    std::future<json> cancel_order(const std::string& access_token, const std::string& order_id);
+    void cancel_order(const std::string& access_token, const std::string& order_id, Callback on_done);
+
+    std::future<json> modify_order(const std::string& access_token, const std::string& order_id, int new_amount, double new_price);
+    void modify_order(const std::string& access_token, const std::string& order_id, int new_amount, double new_price, Callback on_done);
+    // Same, snapping to the grid of 'instrument' with the price rounding of
+    // the order's side (edits name neither)
+    std::future<json> modify_order(const std::string& access_token, const std::string& order_id, InstrumentId instrument, bool buy, int new_amount, double new_price);
+    void modify_order(const std::string& access_token, const std::string& order_id, InstrumentId instrument, bool buy, int new_amount, double new_price, Callback on_done);
+
+    // Requests submitted but not yet completed
+    size_t in_flight() const { return in_flight_.load(std::memory_order_relaxed); }
+
+    RateLimiter& rate_limiter() { return limiter_; }
+
+private:
+    struct Request {
+        std::string url;
+        std::string body;
+        std::string order_id;  // edits and cancels, for coalescing
+        RateLimiter::Class request_class;
+        bool retried = false;
+        std::string auth_header;
+        std::string response;
+        curl_slist* headers = nullptr;
+        CURL* easy = nullptr;
+        Callback on_done;
+    };
+
+    void enqueue(const std::string& url, std::string_view body, const std::string& access_token,
+                 std::string_view order_id, Callback on_done);
+    void submit(std::unique_ptr<Request> request);
+    void run();
+    void schedule(std::unique_ptr<Request> request);
+    std::chrono::milliseconds start_queued();
+    void start(std::unique_ptr<Request> request);
+    void complete(CURL* easy, CURLcode result);
+    void fail_all(const std::string& reason);
+
+    RateLimiter own_limiter_;
+    RateLimiter& limiter_;
+    const OrderGrids* grids_ = nullptr;  // none: orders go out as given
+
+    CURLM* multi_ = nullptr;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<size_t> in_flight_{0};
+
+    std::mutex queue_mutex_;
+    std::vector<std::unique_ptr<Request>> queued_;  // guarded by queue_mutex_
+
+    // Owned by the event thread only
+    std::deque<std::unique_ptr<Request>> waiting_[4];  // by RateLimiter::Priority, out of credits
+    std::vector<std::unique_ptr<Request>> active_;
+    std::vector<CURL*> idle_handles_;
+};
+
+#endif
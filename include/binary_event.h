@@ -0,0 +1,189 @@
+#ifndef BINARY_EVENT_H
+#define BINARY_EVENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "feed_decoder.h"
+#include "instrument_registry.h"
+
+// Fixed-layout binary events passed between components.
+// The network thread turns each decoded Notification into records once
+// (encode_events); the book, strategies and the recorder then read plain
+// structs with no parsing, no strings to hash and nothing to free. The same
+// bytes are the recording format (event_recorder.h).
+//
+// Every record starts with an EventHeader and occupies whole 64-byte lines,
+// so records in an EventBuffer never share a cache line and each starts on
+// one. Records are trivially copyable: copying, queueing or writing one is a
+// memcpy of header.size bytes. Text fields are NUL-padded fixed arrays.
+// Instruments are process-local InstrumentIds; recordings carry an
+// InstrumentRecord with the name before an id is first used.
+
+constexpr size_t kEventAlign = 64;
+
+enum class EventType : uint16_t {
+    Instrument = 1,
+    Book = 2,
+    Trade = 3,
+    Ticker = 4,
+    Order = 5,
+};
+
+struct EventHeader {
+    EventType type;
+    uint16_t flags;           // per type, see the records
+    uint32_t size;            // whole record in bytes, a multiple of kEventAlign
+    InstrumentId instrument;
+    uint32_t count;           // BookRecord: levels that follow; 0 otherwise
+    int64_t timestamp;        // exchange time, ms
+    int64_t received_ns;      // local wall clock when the frame was decoded
+};
+
+// Name of an instrument id, emitted into recordings before its first use
+struct alignas(kEventAlign) InstrumentRecord {
+    static constexpr EventType kType = EventType::Instrument;
+    EventHeader header;
+    char name[96];
+};
+
+struct BookLevelRecord {
+    int64_t price_mantissa;   // price = mantissa / 10^scale, as in Decimal
+    int64_t amount_mantissa;
+    int8_t price_scale;
+    int8_t amount_scale;
+    BookLevelUpdate::Action action;
+    uint8_t reserved[5];
+};
+
+// One book message: 'header.count' BookLevelRecords follow the struct,
+// bids first
+struct alignas(kEventAlign) BookRecord {
+    static constexpr EventType kType = EventType::Book;
+    static constexpr uint16_t kSnapshot = 1;  // header.flags
+    EventHeader header;
+    int64_t change_id;
+    int64_t prev_change_id;   // -1 when absent
+    uint32_t bid_count;       // levels [0, bid_count) are bids, the rest asks
+
+    const BookLevelRecord* levels() const { return reinterpret_cast<const BookLevelRecord*>(this + 1); }
+    BookLevelRecord* levels() { return reinterpret_cast<BookLevelRecord*>(this + 1); }
+};
+
+struct alignas(kEventAlign) TradeRecord {
+    static constexpr EventType kType = EventType::Trade;
+    static constexpr uint16_t kBuy = 1;  // header.flags: taker bought
+    EventHeader header;
+    int64_t trade_seq;
+    double price;
+    double amount;
+    char trade_id[32];
+};
+
+struct alignas(kEventAlign) TickerRecord {
+    static constexpr EventType kType = EventType::Ticker;
+    EventHeader header;
+    double best_bid_price;
+    double best_bid_amount;
+    double best_ask_price;
+    double best_ask_amount;
+    double last_price;
+    double mark_price;
+    double index_price;
+};
+
+// user.orders update; header.timestamp is last_update_timestamp
+struct alignas(kEventAlign) OrderRecord {
+    static constexpr EventType kType = EventType::Order;
+    static constexpr uint16_t kBuy = 1;  // header.flags
+    enum class State : uint8_t { Unknown, Open, Filled, Rejected, Cancelled, Untriggered };
+
+    EventHeader header;
+    double price;
+    double amount;
+    double filled_amount;
+    double average_price;
+    char order_id[48];
+    State state;
+};
+
+static_assert(sizeof(EventHeader) == 32, "EventHeader layout is part of the recording format");
+static_assert(sizeof(BookLevelRecord) == 24, "BookLevelRecord layout is part of the recording format");
+static_assert(sizeof(BookRecord) == 64 && sizeof(TradeRecord) == 128 && sizeof(TickerRecord) == 128 &&
+              sizeof(OrderRecord) == 128 && sizeof(InstrumentRecord) == 128,
+              "record sizes are part of the recording format");
+static_assert(std::is_trivially_copyable_v<BookRecord> && std::is_trivially_copyable_v<TradeRecord> &&
+              std::is_trivially_copyable_v<TickerRecord> && std::is_trivially_copyable_v<OrderRecord> &&
+              std::is_trivially_copyable_v<InstrumentRecord>, "records are copied as bytes");
+
+// The record behind 'header'; the caller checks header.type == T::kType
+template <typename T>
+const T& event_cast(const EventHeader& header) {
+    return *reinterpret_cast<const T*>(&header);
+}
+
+// Text of a NUL-padded field
+template <size_t N>
+std::string_view event_text(const char (&field)[N]) {
+    const void* end = std::memchr(field, '\0', N);
+    return std::string_view(field, end ? static_cast<const char*>(end) - field : N);
+}
+
+// Records laid out back to back on 64-byte lines. Keeps its capacity, so a
+// reused buffer stops allocating once it has held its largest batch.
+class EventBuffer {
+public:
+    // A zeroed T plus 'extra' trailing bytes, rounded up to whole lines, with
+    // header.type and header.size filled in. The pointer is valid until the
+    // next append.
+    template <typename T>
+    T* append(size_t extra = 0) {
+        size_t bytes = sizeof(T) + extra;
+        size_t lines = (bytes + kEventAlign - 1) / kEventAlign;
+        Line* at = grow(lines);
+        std::memset(static_cast<void*>(at), 0, lines * kEventAlign);
+        T* record = new (at) T{};
+        record->header.type = T::kType;
+        record->header.size = static_cast<uint32_t>(lines * kEventAlign);
+        return record;
+    }
+
+    // Copies a complete record, e.g. one read back from a recording
+    EventHeader* append_raw(const void* record, size_t size);
+
+    void clear() { used_ = 0; }
+    bool empty() const { return used_ == 0; }
+    const void* data() const { return lines_.data(); }
+    size_t size() const { return used_ * kEventAlign; }
+
+    // f(const EventHeader&) for each record in order
+    template <typename F>
+    void for_each(F&& f) const {
+        for (size_t line = 0; line < used_;) {
+            const EventHeader& header = *reinterpret_cast<const EventHeader*>(&lines_[line]);
+            f(header);
+            line += header.size / kEventAlign;
+        }
+    }
+
+private:
+    struct alignas(kEventAlign) Line {
+        unsigned char bytes[kEventAlign];
+    };
+
+    Line* grow(size_t lines);
+
+    std::vector<Line> lines_;
+    size_t used_ = 0;
+};
+
+// Appends the records of one notification: a BookRecord, one TradeRecord
+// per trade, a TickerRecord or one OrderRecord per order. Kind::Other
+// appends nothing. Returns the number of records appended.
+size_t encode_events(const Notification& notification, EventBuffer& out);
+
+#endif
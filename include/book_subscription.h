@@ -0,0 +1,46 @@
+#ifndef BOOK_SUBSCRIPTION_H
+#define BOOK_SUBSCRIPTION_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Which Deribit order book channel to use for an instrument.
+//
+//   book.<instrument>.<interval>                        incremental: a snapshot,
+//                                                       then every change
+//   book.<instrument>.<group>.<depth>.<interval>        grouped: the top 'depth'
+//                                                       levels, resent whole
+//
+// Raw incremental books cost the most (one message per change, and an
+// authorized connection); 100ms/agg2 batch the changes; grouped books are the
+// cheapest and suit instruments that are only watched.
+struct BookSubscription {
+    enum class Interval : uint8_t { Raw, Ms100, Agg2 };
+
+    std::string instrument;
+    Interval interval = Interval::Ms100;
+    std::string group;  // grouped only: "none", or a price bucket such as "1", "5", "25"
+    int depth = 0;      // grouped only: 1, 10 or 20; 0 selects the incremental channel
+
+    static BookSubscription incremental(std::string instrument, Interval interval = Interval::Raw);
+    static BookSubscription grouped(std::string instrument, int depth, Interval interval = Interval::Ms100,
+                                    std::string group = "none");
+
+    bool is_grouped() const { return depth > 0; }
+
+    // False for combinations Deribit does not offer (grouped raw, odd depths)
+    bool is_valid() const;
+
+    std::string channel() const;
+
+    // Accepts either channel format; false if 'channel' is not a book channel.
+    // Assigns into 'out' in place, so a reused BookSubscription stops
+    // allocating once its strings have grown.
+    static bool parse(std::string_view channel, BookSubscription& out);
+};
+
+const char* to_string(BookSubscription::Interval interval);
+bool parse_interval(std::string_view text, BookSubscription::Interval& out);
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef CURL_POOL_H
+#define CURL_POOL_H
+
+#include <curl/curl.h>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Per-host pool of reusable CURL easy handles.
+// A handle keeps its connection cache between transfers, so an order sent
+// through a pooled handle skips the TCP connect and TLS handshake as long as
+// the previous connection to that host is still alive.
+class CurlPool {
+public:
+    // RAII lease: the handle goes back to the pool when the lease dies.
+    class Handle {
+    public:
+        Handle() = default;
+        Handle(CurlPool* pool, std::string host, CURL* curl);
+        Handle(Handle&& other) noexcept;
+        Handle& operator=(Handle&& other) noexcept;
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+        ~Handle();
+
+        CURL* get() const { return curl_; }
+        explicit operator bool() const { return curl_ != nullptr; }
+
+    private:
+        void release();
+
+        CurlPool* pool_ = nullptr;
+        std::string host_;
+        CURL* curl_ = nullptr;
+    };
+
+    explicit CurlPool(size_t max_idle_per_host = 4);
+    ~CurlPool();
+
+    CurlPool(const CurlPool&) = delete;
+    CurlPool& operator=(const CurlPool&) = delete;
+
+    // Hands out an idle handle for the host of 'url', or a fresh one.
+    Handle acquire(const std::string& url);
+
+    // Opens 'count' connections up front by issuing a GET to 'url'
+    // (e.g. public/test) so the first real request finds a warm handle.
+    void warm_up(const std::string& url, size_t count = 1);
+
+    static std::string host_of(const std::string& url);
+
+private:
+    CURL* create_handle();
+    void apply_defaults(CURL* curl);
+    void release(const std::string& host, CURL* curl);
+
+    static void share_lock(CURL*, curl_lock_data data, curl_lock_access, void* userptr);
+    static void share_unlock(CURL*, curl_lock_data data, void* userptr);
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::vector<CURL*>> idle_;
+    size_t max_idle_per_host_;
+
+    // DNS and TLS session caches shared by every handle in the pool
+    CURLSH* share_ = nullptr;
+    std::mutex share_mutexes_[CURL_LOCK_DATA_LAST];
+};
+
+#endif
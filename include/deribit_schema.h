@@ -0,0 +1,256 @@
+#ifndef DERIBIT_SCHEMA_H
+#define DERIBIT_SCHEMA_H
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "schema_decoder.h"
+
+// Typed results of the Deribit REST methods, decoded by decode_response().
+// Only the fields declared in each Schema are read; the rest of the
+// response is skipped. Prices come back as doubles, as the API sends them;
+// fields that are absent or null keep the defaults below.
+
+// public/auth
+struct AuthToken {
+    std::string access_token;
+    std::string refresh_token;
+    std::string token_type;
+    std::string scope;
+    int64_t expires_in = 0;  // seconds
+};
+
+// private/buy, private/sell, private/edit, private/cancel
+struct Order {
+    std::string order_id;
+    std::string instrument_name;
+    std::string direction;    // "buy" / "sell"
+    std::string order_state;  // "open", "filled", "cancelled", ...
+    std::string order_type;
+    std::string label;
+    double price = 0.0;  // stays 0 for market orders ("market_price")
+    double amount = 0.0;
+    double filled_amount = 0.0;
+    double average_price = 0.0;
+    int64_t creation_timestamp = 0;
+    int64_t last_update_timestamp = 0;
+    bool post_only = false;
+    bool reduce_only = false;
+};
+
+struct Trade {
+    std::string trade_id;
+    std::string order_id;
+    std::string instrument_name;
+    std::string direction;
+    int64_t trade_seq = 0;
+    int64_t timestamp = 0;
+    double price = 0.0;
+    double amount = 0.0;
+    double fee = 0.0;
+};
+
+// Result of private/buy, private/sell and private/edit
+struct OrderPlacement {
+    Order order;
+    std::vector<Trade> trades;
+};
+
+struct InstrumentStats {
+    double high = 0.0;
+    double low = 0.0;
+    double volume = 0.0;
+    double price_change = 0.0;
+};
+
+// public/ticker
+struct Ticker {
+    std::string instrument_name;
+    std::string state;
+    int64_t timestamp = 0;
+    double best_bid_price = 0.0;
+    double best_bid_amount = 0.0;
+    double best_ask_price = 0.0;
+    double best_ask_amount = 0.0;
+    double last_price = 0.0;
+    double mark_price = 0.0;
+    double index_price = 0.0;
+    double open_interest = 0.0;
+    double funding_8h = 0.0;
+    InstrumentStats stats;
+};
+
+// [price, amount]
+struct PriceLevel {
+    double price = 0.0;
+    double amount = 0.0;
+};
+
+// public/get_order_book: the ticker fields plus the top levels
+struct OrderBookSnapshot : Ticker {
+    int64_t change_id = 0;
+    std::vector<PriceLevel> bids;
+    std::vector<PriceLevel> asks;
+};
+
+// public/get_instrument: the grid orders must be placed on
+struct InstrumentSpec {
+    std::string instrument_name;
+    std::string kind;
+    double tick_size = 0.0;
+    double min_trade_amount = 0.0;
+    double contract_size = 0.0;
+};
+
+// private/get_positions (one entry per instrument)
+struct Position {
+    std::string instrument_name;
+    std::string direction;
+    std::string kind;
+    double size = 0.0;
+    double average_price = 0.0;
+    double mark_price = 0.0;
+    double index_price = 0.0;
+    double floating_profit_loss = 0.0;
+    double realized_profit_loss = 0.0;
+    double total_profit_loss = 0.0;
+    double leverage = 0.0;
+};
+
+template <>
+struct Schema<AuthToken> {
+    static constexpr auto fields = std::make_tuple(
+        field("access_token", &AuthToken::access_token),
+        field("refresh_token", &AuthToken::refresh_token),
+        field("token_type", &AuthToken::token_type),
+        field("scope", &AuthToken::scope),
+        field("expires_in", &AuthToken::expires_in));
+};
+
+template <>
+struct Schema<Order> {
+    static constexpr auto fields = std::make_tuple(
+        field("order_id", &Order::order_id),
+        field("instrument_name", &Order::instrument_name),
+        field("direction", &Order::direction),
+        field("order_state", &Order::order_state),
+        field("order_type", &Order::order_type),
+        field("label", &Order::label),
+        field("price", &Order::price),
+        field("amount", &Order::amount),
+        field("filled_amount", &Order::filled_amount),
+        field("average_price", &Order::average_price),
+        field("creation_timestamp", &Order::creation_timestamp),
+        field("last_update_timestamp", &Order::last_update_timestamp),
+        field("post_only", &Order::post_only),
+        field("reduce_only", &Order::reduce_only));
+};
+
+template <>
+struct Schema<Trade> {
+    static constexpr auto fields = std::make_tuple(
+        field("trade_id", &Trade::trade_id),
+        field("order_id", &Trade::order_id),
+        field("instrument_name", &Trade::instrument_name),
+        field("direction", &Trade::direction),
+        field("trade_seq", &Trade::trade_seq),
+        field("timestamp", &Trade::timestamp),
+        field("price", &Trade::price),
+        field("amount", &Trade::amount),
+        field("fee", &Trade::fee));
+};
+
+template <>
+struct Schema<OrderPlacement> {
+    static constexpr auto fields = std::make_tuple(
+        field("order", &OrderPlacement::order),
+        field("trades", &OrderPlacement::trades));
+};
+
+template <>
+struct Schema<InstrumentStats> {
+    static constexpr auto fields = std::make_tuple(
+        field("high", &InstrumentStats::high),
+        field("low", &InstrumentStats::low),
+        field("volume", &InstrumentStats::volume),
+        field("price_change", &InstrumentStats::price_change));
+};
+
+template <>
+struct Schema<Ticker> {
+    static constexpr auto fields = std::make_tuple(
+        field("instrument_name", &Ticker::instrument_name),
+        field("state", &Ticker::state),
+        field("timestamp", &Ticker::timestamp),
+        field("best_bid_price", &Ticker::best_bid_price),
+        field("best_bid_amount", &Ticker::best_bid_amount),
+        field("best_ask_price", &Ticker::best_ask_price),
+        field("best_ask_amount", &Ticker::best_ask_amount),
+        field("last_price", &Ticker::last_price),
+        field("mark_price", &Ticker::mark_price),
+        field("index_price", &Ticker::index_price),
+        field("open_interest", &Ticker::open_interest),
+        field("funding_8h", &Ticker::funding_8h),
+        field("stats", &Ticker::stats));
+};
+
+template <>
+struct Schema<PriceLevel> {
+    static constexpr bool positional = true;
+    static constexpr auto fields = std::make_tuple(
+        field("price", &PriceLevel::price),
+        field("amount", &PriceLevel::amount));
+};
+
+template <>
+struct Schema<OrderBookSnapshot> {
+    // Members inherited from Ticker are named through the derived type so
+    // the member pointers apply to an OrderBookSnapshot
+    using S = OrderBookSnapshot;
+    static constexpr auto fields = std::make_tuple(
+        field<S, std::string>("instrument_name", &S::instrument_name),
+        field<S, std::string>("state", &S::state),
+        field<S, int64_t>("timestamp", &S::timestamp),
+        field<S, double>("best_bid_price", &S::best_bid_price),
+        field<S, double>("best_bid_amount", &S::best_bid_amount),
+        field<S, double>("best_ask_price", &S::best_ask_price),
+        field<S, double>("best_ask_amount", &S::best_ask_amount),
+        field<S, double>("last_price", &S::last_price),
+        field<S, double>("mark_price", &S::mark_price),
+        field<S, double>("index_price", &S::index_price),
+        field<S, double>("open_interest", &S::open_interest),
+        field<S, double>("funding_8h", &S::funding_8h),
+        field<S, InstrumentStats>("stats", &S::stats),
+        field("change_id", &S::change_id),
+        field("bids", &S::bids),
+        field("asks", &S::asks));
+};
+
+template <>
+struct Schema<InstrumentSpec> {
+    static constexpr auto fields = std::make_tuple(
+        field("instrument_name", &InstrumentSpec::instrument_name),
+        field("kind", &InstrumentSpec::kind),
+        field("tick_size", &InstrumentSpec::tick_size),
+        field("min_trade_amount", &InstrumentSpec::min_trade_amount),
+        field("contract_size", &InstrumentSpec::contract_size));
+};
+
+template <>
+struct Schema<Position> {
+    static constexpr auto fields = std::make_tuple(
+        field("instrument_name", &Position::instrument_name),
+        field("direction", &Position::direction),
+        field("kind", &Position::kind),
+        field("size", &Position::size),
+        field("average_price", &Position::average_price),
+        field("mark_price", &Position::mark_price),
+        field("index_price", &Position::index_price),
+        field("floating_profit_loss", &Position::floating_profit_loss),
+        field("realized_profit_loss", &Position::realized_profit_loss),
+        field("total_profit_loss", &Position::total_profit_loss),
+        field("leverage", &Position::leverage));
+};
+
+#endif
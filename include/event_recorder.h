@@ -0,0 +1,43 @@
+#ifndef EVENT_RECORDER_H
+#define EVENT_RECORDER_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "binary_event.h"
+
+// Recording of binary events: a 64-byte file header, then records exactly
+// as they sit in an EventBuffer, so writing a batch is one fwrite and
+// replaying it is a copy. Instrument ids only mean something inside the
+// process that wrote them; the recorder writes an InstrumentRecord with the
+// name before the first record of each id, and load_recording() maps them
+// onto this process's registry.
+class EventRecorder {
+public:
+    explicit EventRecorder(const std::string& path);
+    ~EventRecorder();
+
+    EventRecorder(const EventRecorder&) = delete;
+    EventRecorder& operator=(const EventRecorder&) = delete;
+
+    bool is_open() const { return file_ != nullptr; }
+
+    // False once a write has failed; the recording is then truncated
+    bool write(const EventBuffer& events);
+    void flush();
+
+private:
+    bool write_bytes(const void* data, size_t size);
+    void name_instrument(InstrumentId id);
+
+    std::FILE* file_ = nullptr;
+    std::vector<bool> named_;  // by InstrumentId
+    bool ok_ = true;
+};
+
+// Appends the records of a recording to 'out' with their instrument ids
+// translated. False when the file cannot be read, is not a recording or is
+// damaged; the records before the damage are kept.
+bool load_recording(const std::string& path, EventBuffer& out);
+
+#endif
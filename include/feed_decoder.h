@@ -0,0 +1,122 @@
+#ifndef FEED_DECODER_H
+#define FEED_DECODER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "book_subscription.h"
+#include "fixed_point.h"
+#include "instrument_registry.h"
+#include "json_scanner.h"
+#include "json.hpp"
+
+using json = nlohmann::json;
+
+// Typed views of Deribit subscription notifications. A Notification is meant
+// to be reused: decoding clears the vectors and overwrites the strings, so
+// once their capacity has grown no further allocations are needed.
+
+// Price and amount are kept as exact decimals straight from the frame text;
+// the book converts them to its instrument's tick grid
+struct BookLevelUpdate {
+    enum class Action : uint8_t { New, Change, Delete };
+    Action action;
+    Decimal price;
+    Decimal amount;
+};
+
+// book.<instrument>.<interval> (raw / 100ms / agg2): a snapshot, then changes.
+// book.<instrument>.<group>.<depth>.<interval>: every message is a snapshot
+// of the top 'depth' levels, decoded with snapshot = true.
+struct BookUpdate {
+    std::string instrument;
+    bool snapshot = false;
+    int64_t timestamp = 0;
+    int64_t change_id = 0;
+    int64_t prev_change_id = -1;  // -1 when absent (snapshots)
+    std::vector<BookLevelUpdate> bids;
+    std::vector<BookLevelUpdate> asks;
+};
+
+// trades.<instrument>.<interval>
+struct TradeEvent {
+    std::string instrument;
+    std::string trade_id;
+    int64_t trade_seq = 0;
+    int64_t timestamp = 0;
+    double price = 0.0;
+    double amount = 0.0;
+    bool buy = false;  // taker direction
+};
+
+// ticker.<instrument>.<interval>
+struct TickerEvent {
+    std::string instrument;
+    int64_t timestamp = 0;
+    double best_bid_price = 0.0;
+    double best_bid_amount = 0.0;
+    double best_ask_price = 0.0;
+    double best_ask_amount = 0.0;
+    double last_price = 0.0;
+    double mark_price = 0.0;
+    double index_price = 0.0;
+};
+
+// user.orders.<instrument>.<interval>
+struct UserOrderEvent {
+    std::string order_id;
+    std::string instrument;
+    std::string order_state;
+    bool buy = false;
+    double price = 0.0;
+    double amount = 0.0;
+    double filled_amount = 0.0;
+    double average_price = 0.0;
+    int64_t last_update_timestamp = 0;
+};
+
+struct Notification {
+    enum class Kind { None, Book, Trades, Ticker, UserOrders, Other };
+
+    Kind kind = Kind::None;
+    std::string channel;
+    // Interned instrument of the channel; kNoInstrument for Kind::Other, for
+    // kind/currency channels (trades.future.BTC.raw) and for instruments
+    // never interned (WebSocketClient::subscribe interns)
+    InstrumentId instrument = kNoInstrument;
+    std::string_view raw;  // the decoded frame, valid only inside the handler
+
+    BookUpdate book;
+    std::vector<TradeEvent> trades;
+    TickerEvent ticker;
+    std::vector<UserOrderEvent> orders;
+    size_t trade_count = 0;  // entries of 'trades' that belong to this message
+    size_t order_count = 0;  // entries of 'orders' that belong to this message
+};
+
+// SAX decoder for subscription notifications. Fields go straight from the
+// frame bytes into the Notification; no json DOM is built, and once the
+// Notification's strings and vectors have grown nothing is allocated.
+// Channels other than book/trades/ticker/user.orders decode as Kind::Other
+// with only 'channel' and 'raw' set. Frames that are not notifications
+// (responses, heartbeats) return false and leave kind == None.
+// Typed frames without a payload, and book.<instrument>.<interval> frames
+// without a "type", are rejected like non-notifications.
+// Key order does not matter: a frame whose "data" precedes its "channel" is
+// read a second time once the channel has told what the payload is.
+class FeedDecoder {
+public:
+    bool decode(std::string_view frame, Notification& out);
+
+    // book.*, trades.*, ticker.* and user.orders.*: the typed channels.
+    // Most name one instrument; trades and user.orders also come by kind and
+    // currency (see InstrumentRegistry::instrument_of).
+    static bool carries_instrument(std::string_view channel);
+
+private:
+    JsonScanner scanner_;  // reads the frame in place, keeps its scratch buffer
+    BookSubscription book_;  // the last book channel, parsed in place
+};
+
+#endif
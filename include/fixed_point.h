@@ -0,0 +1,98 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Exact decimal: value = mantissa / 10^scale ("36950.5" -> {369505, 1})
+struct Decimal {
+    int64_t mantissa = 0;
+    int scale = 0;
+};
+
+// Hand-written parser for JSON/decimal numbers ("-12.50", "5e-05", "100").
+// No strtod, no locale. Fails on overflow past 18 significant digits.
+bool parse_decimal(std::string_view text, Decimal& out);
+
+double to_double(Decimal value);
+
+// Writes the shortest plain decimal form (no exponent, no trailing zeros)
+// and returns the number of characters; 'out' needs room for 24 chars.
+size_t format_decimal(Decimal value, char* out);
+
+// Price or amount counted in whole grid units (ticks, amount steps), so book
+// arithmetic and comparisons are exact integer operations.
+template <typename Tag>
+struct Fixed {
+    int64_t units = 0;
+
+    constexpr Fixed() = default;
+    constexpr explicit Fixed(int64_t u) : units(u) {}
+
+    constexpr Fixed operator+(Fixed other) const { return Fixed(units + other.units); }
+    constexpr Fixed operator-(Fixed other) const { return Fixed(units - other.units); }
+    constexpr bool operator==(Fixed other) const { return units == other.units; }
+    constexpr bool operator!=(Fixed other) const { return units != other.units; }
+    constexpr bool operator<(Fixed other) const { return units < other.units; }
+    constexpr bool operator>(Fixed other) const { return units > other.units; }
+    constexpr bool operator<=(Fixed other) const { return units <= other.units; }
+    constexpr bool operator>=(Fixed other) const { return units >= other.units; }
+};
+
+struct PriceTag {};
+struct QtyTag {};
+using Price = Fixed<PriceTag>;  // in ticks of the instrument's tick_size
+using Qty = Fixed<QtyTag>;      // in steps of the instrument's amount step
+
+// The grid of one instrument field: tick_size for prices, the minimum
+// trade amount for quantities. Converts between units and decimals.
+class FixedScale {
+public:
+    FixedScale() = default;
+    explicit FixedScale(Decimal unit);
+
+    // "0.5", "0.0001", ...; returns false on a malformed or non-positive unit
+    static bool parse(std::string_view unit_text, FixedScale& out);
+    static FixedScale from_double(double unit);
+
+    // Exact conversion; false when 'value' is not on the grid
+    bool to_units(Decimal value, int64_t& units) const;
+    // Nearest grid point, halves rounded away from zero
+    int64_t to_units_nearest(Decimal value) const;
+    int64_t to_units_nearest(double value) const;
+    // Grid point at or below / at or above 'value'; a double within rounding
+    // noise of a grid point (0.1 + 0.2 on a 0.1 grid) counts as on it
+    int64_t to_units_floor(double value) const;
+    int64_t to_units_ceil(double value) const;
+
+    Decimal to_decimal(int64_t units) const { return {units * unit_.mantissa, unit_.scale}; }
+    double to_double(int64_t units) const;
+    size_t format(int64_t units, char* out) const { return format_decimal(to_decimal(units), out); }
+
+    Decimal unit() const { return unit_; }
+
+private:
+    Decimal unit_{1, 0};
+};
+
+// Where an instrument's orders must land: prices on its tick_size, amounts
+// on its minimum trade amount. Snapping yields an exact Decimal for
+// RpcEncoder, so off-grid input is corrected before it is sent instead of
+// being rejected by the exchange, and it never asks for more than the
+// caller did: amounts round toward zero (below one step gives 0, which the
+// order paths refuse) and prices round away from the other side, bids down
+// and asks up, so a snapped limit is never more aggressive.
+struct OrderGrid {
+    FixedScale tick;
+    FixedScale amount_step;
+
+    Decimal price(double value, bool buy) const {
+        return tick.to_decimal(buy ? tick.to_units_floor(value) : tick.to_units_ceil(value));
+    }
+    Decimal amount(double value) const {
+        return amount_step.to_decimal(value < 0 ? amount_step.to_units_ceil(value) : amount_step.to_units_floor(value));
+    }
+};
+
+#endif
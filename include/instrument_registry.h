@@ -0,0 +1,133 @@
+#ifndef INSTRUMENT_REGISTRY_H
+#define INSTRUMENT_REGISTRY_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Dense id of an interned instrument name; ids start at 0 and never change
+using InstrumentId = uint32_t;
+constexpr InstrumentId kNoInstrument = UINT32_MAX;
+
+// Process-wide instrument names <-> dense ids.
+// Names are interned once (at subscription time, say), after which the hot
+// path carries the id and per-instrument state lives in InstrumentTables
+// indexed by it.
+//
+// find() is lock-free: each intern() of a new name builds a minimal perfect
+// hash over all names (hash and displace: a per-bucket seed moves every
+// name to its own slot) and publishes it as an immutable snapshot. A lookup
+// is one hash, one table read and one string compare, with no probing.
+// Each rebuild costs O(names), so intern in bulk where possible.
+//
+// Readers load the snapshot without any check-in, so nothing can tell
+// when the last of them is done with a superseded one: superseded snapshots
+// are kept until the registry is destroyed. Interning happens in bulk (one
+// rebuild per subscription batch), so there are only a handful of them.
+class InstrumentRegistry {
+public:
+    InstrumentRegistry();
+    ~InstrumentRegistry();
+
+    InstrumentRegistry(const InstrumentRegistry&) = delete;
+    InstrumentRegistry& operator=(const InstrumentRegistry&) = delete;
+
+    // The registry shared by API, WebSocketClient and FeedDecoder
+    static InstrumentRegistry& instance();
+
+    // Id of 'name', adding it if new; safe from any thread
+    InstrumentId intern(std::string_view name);
+    void intern(const std::vector<std::string>& names);
+
+    // kNoInstrument when 'name' was never interned
+    InstrumentId find(std::string_view name) const;
+    // 'id' must come from this registry
+    const std::string& name(InstrumentId id) const;
+    size_t size() const;
+
+    // "book.BTC-PERPETUAL.raw" -> "BTC-PERPETUAL", "user.orders.ETH-PERPETUAL.raw" -> "ETH-PERPETUAL".
+    // Empty for channels by kind and currency ("trades.future.BTC.raw"),
+    // which carry many instruments.
+    static std::string_view instrument_of(std::string_view channel);
+
+private:
+    struct Table {
+        std::vector<const std::string*> names;  // by id
+        std::vector<uint32_t> seeds;            // by bucket
+        std::vector<InstrumentId> slots;        // kNoInstrument when empty
+        uint64_t bucket_mask = 0;
+        uint64_t slot_mask = 0;
+    };
+
+    static std::unique_ptr<Table> build(std::vector<const std::string*> names);
+    static uint64_t slot_of(uint64_t hash, uint32_t seed, uint64_t mask);
+    InstrumentId add_locked(std::string_view name);
+    void publish_locked();
+
+    std::atomic<const Table*> table_;
+
+    std::mutex mutex_;  // interning only
+    std::deque<std::string> storage_;  // stable addresses for Table::names
+    std::unordered_map<std::string_view, InstrumentId> ids_;
+    std::unique_ptr<Table> current_;
+    std::vector<std::unique_ptr<Table>> retired_;  // superseded, never freed
+};
+
+// Per-instrument state indexed by InstrumentId: an array lookup instead of
+// hashing the name. Entries are heap-allocated, so their addresses survive
+// the table growing. Not synchronised; owned by one thread, like the books.
+template <typename T>
+class InstrumentTable {
+public:
+    T* find(InstrumentId id) {
+        return id < slots_.size() ? slots_[id].get() : nullptr;
+    }
+    const T* find(InstrumentId id) const {
+        return id < slots_.size() ? slots_[id].get() : nullptr;
+    }
+
+    // Constructs the entry unless it exists already
+    template <typename... Args>
+    T& emplace(InstrumentId id, Args&&... args) {
+        if (id >= slots_.size()) {
+            slots_.resize(static_cast<size_t>(id) + 1);
+        }
+        if (!slots_[id]) {
+            slots_[id] = std::make_unique<T>(std::forward<Args>(args)...);
+            ++count_;
+        }
+        return *slots_[id];
+    }
+
+    void erase(InstrumentId id) {
+        if (id < slots_.size() && slots_[id]) {
+            slots_[id].reset();
+            --count_;
+        }
+    }
+
+    // f(InstrumentId, T&) for every entry, in id order
+    template <typename F>
+    void for_each(F&& f) {
+        for (size_t id = 0; id < slots_.size(); ++id) {
+            if (slots_[id]) {
+                f(static_cast<InstrumentId>(id), *slots_[id]);
+            }
+        }
+    }
+
+    size_t size() const { return count_; }
+
+private:
+    std::vector<std::unique_ptr<T>> slots_;
+    size_t count_ = 0;
+};
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef JSON_INDEX_H
+#define JSON_INDEX_H
+
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+#include <vector>
+
+// Structural index of a JSON frame, built 64 bytes at a time.
+// build() classifies each block with SIMD compares (AVX2 or SSE2, scalar
+// otherwise), masks out everything inside strings using bit arithmetic on
+// the quote and backslash masks, and records the offset of every structural
+// character ({ } [ ] : ,), every opening quote and the first byte of every
+// number or literal. Lookups then jump between those offsets instead of
+// walking the bytes again.
+//
+// The index is not a validator: build() only rejects unterminated strings.
+// Keys are compared as raw bytes, without unescaping; Deribit never escapes
+// key names. The positions vector keeps its capacity, so a reused index
+// allocates nothing once it has seen its largest frame.
+//
+// The index pays off when most of a frame is skipped or only a few paths are
+// looked up: control frames, REST responses. Subscription notifications are
+// read almost field by field, and on them building the index and walking it
+// costs as much as FeedDecoder's single JsonScanner pass or more
+// (bench/feed_decoder_bench), so the feed stays on the scanner.
+class JsonIndex {
+public:
+    bool build(std::string_view text);
+
+    // Raw text of the value at 'path' (object keys from the root), e.g.
+    // find({"params", "channel"}); strings keep their quotes. Empty when a
+    // key is missing or a step is not an object.
+    std::string_view find(std::initializer_list<std::string_view> path) const;
+
+    // Like find(), with the quotes of a string value removed; empty for
+    // values that are not strings
+    std::string_view find_string(std::initializer_list<std::string_view> path) const;
+
+    size_t size() const { return count_; }
+    uint32_t operator[](size_t i) const { return positions_[i]; }
+
+    // Navigation by entry: the root value is entry 0. first_char() tells
+    // the value's type ('{', '[', '"', a digit or '-', 't', 'f', 'n').
+    char first_char(size_t i) const { return text_[positions_[i]]; }
+    // Entry just past the value starting at i. The first skip over an
+    // object or array pairs up all brackets in one pass, so skips are O(1)
+    // from then on; lookups are therefore not safe to share across threads.
+    size_t skip_value(size_t i) const;
+    std::string_view value_text(size_t i) const;  // raw text of the value starting at i
+
+    // Calls f(key, value_entry) for each member of the object at entry i,
+    // stopping when f returns false; false if i is not a well-formed object.
+    // Keys are raw bytes between the quotes.
+    template <typename F>
+    bool for_each_member(size_t i, F&& f) const;
+
+    // Calls f(element_entry) for each element of the array at entry i
+    template <typename F>
+    bool for_each_element(size_t i, F&& f) const;
+
+private:
+    void match_brackets() const;
+
+    std::string_view text_;
+    std::vector<uint32_t> positions_;
+    size_t count_ = 0;
+    // For each opening bracket entry, the entry of its closing bracket
+    // (count_ when unclosed); built on demand, same growth policy
+    mutable std::vector<uint32_t> closers_;
+    mutable bool matched_ = false;
+};
+
+template <typename F>
+bool JsonIndex::for_each_member(size_t i, F&& f) const {
+    if (i >= count_ || first_char(i) != '{') {
+        return false;
+    }
+    size_t member = i + 1;
+    if (member < count_ && first_char(member) == '}') {
+        return true;
+    }
+    for (;;) {
+        // "key" : value
+        if (member + 2 >= count_ || first_char(member) != '"' || first_char(member + 1) != ':') {
+            return false;
+        }
+        std::string_view key = value_text(member);
+        if (key.size() < 2) {
+            return false;
+        }
+        if (!f(key.substr(1, key.size() - 2), member + 2)) {
+            return true;
+        }
+        member = skip_value(member + 2);
+        if (member < count_ && first_char(member) == '}') {
+            return true;
+        }
+        if (member >= count_ || first_char(member) != ',') {
+            return false;
+        }
+        ++member;
+    }
+}
+
+template <typename F>
+bool JsonIndex::for_each_element(size_t i, F&& f) const {
+    if (i >= count_ || first_char(i) != '[') {
+        return false;
+    }
+    size_t element = i + 1;
+    if (element < count_ && first_char(element) == ']') {
+        return true;
+    }
+    for (;;) {
+        if (element >= count_) {
+            return false;
+        }
+        if (!f(element)) {
+            return true;
+        }
+        element = skip_value(element);
+        if (element < count_ && first_char(element) == ']') {
+            return true;
+        }
+        if (element >= count_ || first_char(element) != ',') {
+            return false;
+        }
+        ++element;
+    }
+}
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef JSON_SCANNER_H
+#define JSON_SCANNER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// In-place JSON reader for the receive path.
+// Walks the frame bytes once and reports events to a handler; strings and
+// numbers are handed over as views into the frame, so nothing is allocated
+// per message. Only strings with escape sequences are copied, into a scratch
+// buffer that keeps its capacity across frames.
+//
+// Handler interface (return false to stop):
+//   bool start_object(); bool end_object(); bool start_array(); bool end_array();
+//   bool key(std::string_view); bool string(std::string_view);
+//   bool number(std::string_view literal, bool is_integer);
+//   bool boolean(bool); bool null();
+// The views are only valid during the call.
+class JsonScanner {
+public:
+    static constexpr int kMaxDepth = 64;
+
+    template <typename Handler>
+    bool parse(std::string_view text, Handler& handler);
+
+private:
+    bool read_string(const char*& p, const char* end, std::string_view& out);
+    static bool read_number(const char*& p, const char* end, std::string_view& out, bool& is_integer);
+    static bool read_literal(const char*& p, const char* end, std::string_view literal);
+
+    static void skip_space(const char*& p, const char* end) {
+        while (p != end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) ++p;
+    }
+
+    std::string scratch_;
+};
+
+template <typename Handler>
+bool JsonScanner::parse(std::string_view text, Handler& handler) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    char stack[kMaxDepth];  // '{' or '[' per open container
+    int depth = 0;
+    std::string_view token;
+
+    skip_space(p, end);
+    for (;;) {
+        // A value is expected at p
+        if (p == end) return false;
+        switch (*p) {
+            case '{':
+                ++p;
+                if (depth == kMaxDepth || !handler.start_object()) return false;
+                stack[depth++] = '{';
+                skip_space(p, end);
+                if (p != end && *p == '}') {
+                    ++p;
+                    --depth;
+                    if (!handler.end_object()) return false;
+                    break;
+                }
+                if (p == end || *p != '"' || !read_string(p, end, token) || !handler.key(token)) return false;
+                skip_space(p, end);
+                if (p == end || *p != ':') return false;
+                ++p;
+                skip_space(p, end);
+                continue;
+            case '[':
+                ++p;
+                if (depth == kMaxDepth || !handler.start_array()) return false;
+                stack[depth++] = '[';
+                skip_space(p, end);
+                if (p != end && *p == ']') {
+                    ++p;
+                    --depth;
+                    if (!handler.end_array()) return false;
+                    break;
+                }
+                continue;
+            case '"':
+                if (!read_string(p, end, token) || !handler.string(token)) return false;
+                break;
+            case 't':
+                if (!read_literal(p, end, "true") || !handler.boolean(true)) return false;
+                break;
+            case 'f':
+                if (!read_literal(p, end, "false") || !handler.boolean(false)) return false;
+                break;
+            case 'n':
+                if (!read_literal(p, end, "null") || !handler.null()) return false;
+                break;
+            default: {
+                bool is_integer = false;
+                if (!read_number(p, end, token, is_integer) || !handler.number(token, is_integer)) return false;
+                break;
+            }
+        }
+
+        // After a value: close containers or move on to the next member
+        for (;;) {
+            skip_space(p, end);
+            if (depth == 0) {
+                return p == end;
+            }
+            if (p == end) return false;
+            char container = stack[depth - 1];
+            if (*p == ',') {
+                ++p;
+                skip_space(p, end);
+                if (container == '{') {
+                    if (p == end || *p != '"' || !read_string(p, end, token) || !handler.key(token)) return false;
+                    skip_space(p, end);
+                    if (p == end || *p != ':') return false;
+                    ++p;
+                    skip_space(p, end);
+                }
+                break;
+            }
+            if ((container == '{' && *p == '}') || (container == '[' && *p == ']')) {
+                ++p;
+                --depth;
+                if (!(container == '{' ? handler.end_object() : handler.end_array())) return false;
+                continue;
+            }
+            return false;
+        }
+    }
+}
+
+#endif
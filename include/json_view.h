@@ -0,0 +1,81 @@
+#ifndef JSON_VIEW_H
+#define JSON_VIEW_H
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include "json_index.h"
+#include "schema_decoder.h"
+
+// Read-only, lazy view of one value in a JsonIndex.
+// Looking up a member or element only moves between structural offsets;
+// nothing is converted until get() is called on a scalar, so reading a few
+// fields of a large response never touches the rest of it (the bid/ask
+// arrays of a depth snapshot are stepped over, not parsed). get<T>()
+// accepts anything decode() does: strings, numbers, bools and Schema types.
+//
+// A view borrows the index and the text it was built over; both must
+// outlive it. A missing key, an out-of-range position or a step into a
+// scalar gives an empty view, and every lookup on an empty view is empty
+// too, so chains like view["stats"]["high"] need no checks in between.
+class JsonView {
+public:
+    JsonView() = default;
+    JsonView(const JsonIndex& index, size_t entry)
+        : index_(entry < index.size() ? &index : nullptr), entry_(entry) {}
+
+    explicit operator bool() const { return index_ != nullptr; }
+
+    // '{', '[', '"', a digit or '-', 't', 'f', 'n'; '\0' for an empty view
+    char kind() const { return index_ ? index_->first_char(entry_) : '\0'; }
+    bool is_object() const { return kind() == '{'; }
+    bool is_array() const { return kind() == '['; }
+    bool is_string() const { return kind() == '"'; }
+    bool is_number() const { char c = kind(); return c == '-' || (c >= '0' && c <= '9'); }
+    bool is_bool() const { return kind() == 't' || kind() == 'f'; }
+    bool is_null() const { return kind() == 'n'; }
+
+    JsonView operator[](std::string_view key) const;
+    JsonView operator[](size_t position) const;
+
+    // Members of an object or elements of an array; 0 for scalars
+    size_t size() const;
+
+    // Raw text of the value; strings keep their quotes and escapes
+    std::string_view raw() const { return index_ ? index_->value_text(entry_) : std::string_view(); }
+
+    // Empty when the value is missing or not convertible to T
+    template <typename T>
+    std::optional<T> get() const {
+        T value{};
+        if (!index_ || !decode(*index_, entry_, value)) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    template <typename T>
+    T value_or(T fallback) const {
+        return get<T>().value_or(std::move(fallback));
+    }
+
+    // f(key, JsonView) per member, f(JsonView) per element; stop when f returns false
+    template <typename F>
+    bool for_each_member(F&& f) const {
+        return index_ && index_->for_each_member(entry_, [&](std::string_view key, size_t value) {
+            return f(key, JsonView(*index_, value));
+        });
+    }
+    template <typename F>
+    bool for_each_element(F&& f) const {
+        return index_ && index_->for_each_element(entry_, [&](size_t element) {
+            return f(JsonView(*index_, element));
+        });
+    }
+
+private:
+    const JsonIndex* index_ = nullptr;
+    size_t entry_ = 0;
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Log-linear latency histogram: 16 linear sub-buckets per power of two, so
+// any recorded value is reported within ~6% from 1ns up to minutes. Counters
+// are relaxed atomics: one thread records (the io_context thread), any
+// thread may read percentiles, and a reader only ever sees a slightly stale
+// but usable distribution.
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    void record(std::chrono::nanoseconds value);
+    void reset();
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    std::chrono::nanoseconds min() const;
+    std::chrono::nanoseconds max() const;
+    std::chrono::nanoseconds mean() const;
+    // p in [0, 100]; zero when nothing has been recorded
+    std::chrono::nanoseconds percentile(double p) const;
+
+private:
+    static constexpr int kSubBits = 4;
+    static constexpr size_t kSubBuckets = size_t{1} << kSubBits;
+    static constexpr size_t kBuckets = 64 * kSubBuckets;
+
+    static size_t bucket_of(uint64_t ns);
+    static uint64_t value_of(size_t bucket);
+
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_;
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> min_{UINT64_MAX};
+    std::atomic<uint64_t> max_{0};
+};
+
+#endif
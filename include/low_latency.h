@@ -0,0 +1,21 @@
+#ifndef LOW_LATENCY_H
+#define LOW_LATENCY_H
+
+#include <boost/asio.hpp>
+#include <vector>
+
+// Spin mode for latency-critical threads. Instead of sleeping in epoll_wait
+// until the kernel wakes it, the thread polls the io_context in a loop and
+// picks up a frame as soon as it lands in the socket buffer. This costs one
+// core at 100% and saves the wakeup and scheduling latency on every message,
+// so it only makes sense on a core nothing else runs on.
+
+// Restricts the calling thread to 'cpus'; false (with a warning) if that
+// fails or the platform has no thread affinity
+bool pin_current_thread(const std::vector<int>& cpus);
+
+// Like ioc.run(), but never blocks: ready handlers run as soon as their
+// sockets are readable. Returns when the context is stopped or runs out of work.
+void run_spinning(boost::asio::io_context& ioc);
+
+#endif
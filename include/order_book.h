@@ -0,0 +1,173 @@
+#ifndef ORDER_BOOK_H
+#define ORDER_BOOK_H
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include "binary_event.h"
+#include "book_subscription.h"
+#include "feed_decoder.h"
+#include "instrument_registry.h"
+#include "price_ladder.h"
+#include "seqlock.h"
+#include "websocket_client.h"
+
+struct BookLevel {
+    Price price;  // in ticks; OrderBook::tick_scale() converts
+    double amount;
+};
+
+// Top levels of a book, copied out for other threads (see
+// OrderBookManager::snapshot). Prices are in ticks; tick converts them.
+struct BookSnapshot {
+    static constexpr size_t kDepth = 10;
+
+    bool valid = false;  // false while the book waits for a snapshot
+    uint32_t bid_count = 0;
+    uint32_t ask_count = 0;
+    int64_t change_id = 0;
+    int64_t timestamp = 0;
+    FixedScale tick;
+    BookLevel bids[kDepth];
+    BookLevel asks[kDepth];
+};
+
+// Expected execution of a market order against the current book
+struct FillEstimate {
+    double filled = 0.0;         // less than asked for when the book runs out
+    double average_price = 0.0;
+    double worst_price = 0.0;    // limit price that would fill it all
+    double slippage_bps = 0.0;   // average against the best price, positive when worse
+};
+
+// L2 book for one instrument, maintained from book.* notifications.
+// A "snapshot" replaces the book; a "change" applies new/change/delete level
+// updates and must continue the change_id sequence (prev_change_id equal to
+// the last change_id seen), otherwise the book is marked invalid. So is a
+// book whose side grows wider than PriceLadder::kMaxLevels ticks.
+class OrderBook {
+public:
+    OrderBook(std::string instrument, FixedScale tick);
+
+    // Returns false when the update did not continue the sequence
+    bool apply(const BookUpdate& update);
+    bool apply(const BookRecord& record);
+    void invalidate() { valid_ = false; }
+
+    bool is_valid() const { return valid_; }
+    const std::string& instrument() const { return instrument_; }
+    int64_t change_id() const { return change_id_; }
+    int64_t timestamp() const { return timestamp_; }
+    const FixedScale& tick_scale() const { return tick_; }
+
+    std::optional<BookLevel> best_bid() const;
+    std::optional<BookLevel> best_ask() const;
+    std::vector<BookLevel> bids(size_t depth) const;
+    std::vector<BookLevel> asks(size_t depth) const;
+
+    // Depth queries for sizing orders, cheap enough to run on every tick
+    // (PriceLadder::sweep). Buys take the asks, sells the bids; empty when
+    // that side is.
+    std::optional<FillEstimate> estimate_fill(bool buy, double amount) const;
+    // Amount resting within 'bps' of the best price of a side
+    double depth_within_bps(PriceLadder::Side side, double bps) const;
+
+    // Top BookSnapshot::kDepth levels of each side
+    void fill_snapshot(BookSnapshot& out) const;
+
+private:
+    // Checks the sequence and clears the book for a snapshot
+    bool begin(bool snapshot, int64_t prev_change_id);
+    void check_complete();
+    void apply_levels(PriceLadder& side, const std::vector<BookLevelUpdate>& levels);
+    void apply_levels(PriceLadder& side, const BookLevelRecord* begin, const BookLevelRecord* end);
+
+    std::string instrument_;
+    FixedScale tick_;
+    PriceLadder bids_;
+    PriceLadder asks_;
+    int64_t change_id_ = 0;
+    int64_t timestamp_ = 0;
+    bool valid_ = false;
+};
+
+// Keeps one OrderBook per instrument fed from its book channel, which it
+// reads as binary BookRecords (WebSocketClient::subscribe_events).
+// On a sequence gap the book is invalidated and the channel is subscribed
+// again, which makes Deribit start over with a fresh snapshot; deltas that
+// arrive before it are dropped. When the connection drops every book is marked
+// stale the same way until the resubscription's snapshot arrives.
+// Runs on the WebSocketClient io_context thread; other threads read the
+// books through their published snapshots.
+//
+// track() may be called from any thread, before or after the io_context
+// starts running: the snapshot slot exists when it returns, while the book
+// itself is set up by a handler it posts to the io_context, so the tables
+// the feed reads are only ever touched on that thread.
+//
+// The connection handler is removed on destruction, but the book channels
+// stay subscribed to the manager and handlers posted by track() may still
+// be queued: destroy it only once the io_context has stopped for good.
+class OrderBookManager {
+public:
+    using UpdateHandler = std::function<void(const OrderBook&)>;
+
+    explicit OrderBookManager(WebSocketClient& ws);
+    ~OrderBookManager();
+
+    OrderBookManager(const OrderBookManager&) = delete;
+    OrderBookManager& operator=(const OrderBookManager&) = delete;
+
+    // tick_size is the instrument's price increment (0.5 for BTC-PERPETUAL).
+    // The string overload follows book.<instrument>.raw; a grouped spec gives
+    // a book of only its top levels, replaced whole by every message.
+    void track(const std::string& instrument, double tick_size);
+    void track(const BookSubscription& spec, double tick_size);
+
+    // Called after every update that leaves a book valid. Set it before
+    // the io_context runs.
+    void set_update_handler(UpdateHandler handler) { on_update_ = std::move(handler); }
+
+    // io_context thread only (the update handler, say); nullptr until the
+    // book is set up
+    const OrderBook* book(const std::string& instrument) const;
+    const OrderBook* book(InstrumentId instrument) const;
+
+    // Top levels of the book, republished after every update and whenever
+    // the book goes stale. Callable from any thread once track() has
+    // returned; finding the slot takes a lock, so take the pointer once and
+    // keep it: it lives as long as the manager, and load() never blocks.
+    // nullptr for instruments that are not tracked.
+    const SeqLock<BookSnapshot>* snapshot(InstrumentId instrument) const;
+
+private:
+    struct Tracked {
+        Tracked(std::string instrument, FixedScale tick, SeqLock<BookSnapshot>& published)
+            : book(std::move(instrument), tick), published(published) {}
+
+        OrderBook book;
+        std::string channel;
+        SeqLock<BookSnapshot>& published;
+    };
+
+    void subscribe(const std::string& channel);
+    void on_events(const EventBuffer& events);
+    void on_book(const BookRecord& record);
+    void resync(Tracked& tracked);
+    void publish(Tracked& tracked);
+    void on_connection(WebSocketClient::ConnectionEvent event);
+
+    WebSocketClient& ws_;
+    uint64_t connection_handler_ = 0;
+    InstrumentTable<Tracked> books_;  // io_context thread only
+    // Any thread, under snapshots_mutex_. Entries are never removed and
+    // live on the heap, so a SeqLock's address is stable.
+    mutable std::mutex snapshots_mutex_;
+    InstrumentTable<SeqLock<BookSnapshot>> snapshots_;
+    UpdateHandler on_update_;
+};
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef ORDER_GATEWAY_H
+#define ORDER_GATEWAY_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include <string_view>
+#include "fixed_point.h"
+#include "json.hpp"
+#include "order_grids.h"
+#include "rate_limiter.h"
+#include "websocket_client.h"
+
+using json = nlohmann::json;
+
+// Order entry over an authenticated WebSocket JSON-RPC session.
+// Requests are encoded with RpcEncoder and written as a single frame; the
+// response frame is matched back to its caller through the JSON-RPC id, which
+// comes from the socket's monotonic counter. Callbacks run on the thread that
+// feeds frames into on_message() (the WebSocketClient io_context thread).
+// If the connection drops, requests still waiting for a response complete
+// with an error (whether they reached the matching engine is unknown), and
+// after the reconnect the session is authenticated again with the same
+// credentials. The connection handler is removed on destruction, so the
+// gateway may go away before the WebSocketClient (but not after it).
+//
+// Every request first takes its credits from a RateLimiter, blocking the
+// calling thread until they are there, like API's requests do. Orders over
+// the socket and over REST spend the same account buckets, so pass the
+// limiter shared with API / AsyncAPI (API::rate_limiter()).
+//
+// Given an OrderGrids table (API::order_grids()), the double-valued orders
+// and edits are snapped to their instrument's grid; an amount that snaps to
+// zero completes with an error without being sent. The Decimal variants go
+// out exactly as given.
+class OrderGateway {
+public:
+    using Callback = std::function<void(json)>;
+
+    explicit OrderGateway(WebSocketClient& ws);  // paces requests with its own credit budget
+    OrderGateway(WebSocketClient& ws, RateLimiter& limiter);  // shares the credit budget with another client
+    OrderGateway(WebSocketClient& ws, RateLimiter& limiter, const OrderGrids& grids);  // and the order grids
+    ~OrderGateway();
+
+    OrderGateway(const OrderGateway&) = delete;
+    OrderGateway& operator=(const OrderGateway&) = delete;
+
+    // public/auth with client credentials; later private/* calls on this
+    // socket are authorized by the session, no token is sent per request
+    uint64_t authenticate(const std::string& client_id, const std::string& client_secret, Callback on_done);
+
+    // Each call returns the request id, or 0 if the request was not sent
+    uint64_t buy(const std::string& instrument, int amount, const std::string& type, double price, Callback on_done);
+    uint64_t sell(const std::string& instrument, int amount, const std::string& type, double price, Callback on_done);
+    uint64_t edit(const std::string& order_id, int new_amount, double new_price, Callback on_done);
+    // Same, snapping to the grid of 'instrument' with the price rounding of
+    // the order's side (edits name neither)
+    uint64_t edit(const std::string& order_id, InstrumentId instrument, bool buy, int new_amount, double new_price,
+                  Callback on_done);
+    uint64_t cancel(const std::string& order_id, Callback on_done);
+
+    // Fixed-point variants: amount and price go out with exact digits
+    uint64_t buy(const std::string& instrument, Decimal amount, const std::string& type, Decimal price, Callback on_done);
+    uint64_t sell(const std::string& instrument, Decimal amount, const std::string& type, Decimal price, Callback on_done);
+    uint64_t edit(const std::string& order_id, Decimal new_amount, Decimal new_price, Callback on_done);
+
+    // Feed every received frame here. Returns true when the frame was the
+    // response to one of our requests and its callback has run.
+    bool on_message(std::string_view message);
+
+    size_t pending() const { return pending_.size(); }
+
+private:
+    // Lock-free id -> callback table. Ids are handed out in order, so the slot
+    // is simply id % kSlots; a slot still held by an old request makes the new
+    // one fail instead of overwriting it.
+    class PendingTable {
+    public:
+        static constexpr size_t kSlots = 1024;
+
+        bool insert(uint64_t id, Callback& on_done);  // moves on_done only on success
+        Callback take(uint64_t id);
+        std::vector<Callback> take_all();
+        size_t size() const { return count_.load(std::memory_order_relaxed); }
+
+    private:
+        static constexpr uint64_t kFree = 0;
+        static constexpr uint64_t kBusy = UINT64_MAX;
+
+        struct Slot {
+            std::atomic<uint64_t> id{kFree};
+            Callback on_done;
+        };
+
+        std::array<Slot, kSlots> slots_;
+        std::atomic<size_t> count_{0};
+    };
+
+    uint64_t send(uint64_t id, RateLimiter::Class request_class, std::string_view body, Callback& on_done);
+    uint64_t send_order(bool buy, const std::string& instrument, int amount, const std::string& type, double price,
+                        Callback& on_done);
+    std::optional<OrderGrid> grid_of(InstrumentId instrument) const;
+    uint64_t send_auth(Callback& on_done);
+    void on_connection(WebSocketClient::ConnectionEvent event);
+
+    WebSocketClient& ws_;
+    RateLimiter own_limiter_;
+    RateLimiter& limiter_;
+    uint64_t connection_handler_ = 0;
+    const OrderGrids* grids_ = nullptr;  // none: orders go out as given
+    PendingTable pending_;
+
+    std::mutex credentials_mutex_;
+    std::string client_id_;
+    std::string client_secret_;
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef ORDER_GRIDS_H
+#define ORDER_GRIDS_H
+
+#include <mutex>
+#include <optional>
+#include "fixed_point.h"
+#include "instrument_registry.h"
+
+// Order grids by instrument, shared between the order paths.
+// API::get_instrument() records each instrument's grid here; API, and the
+// AsyncAPI / OrderGateway given the same table, snap outgoing prices and
+// amounts with it. Safe to use from any thread.
+class OrderGrids {
+public:
+    void set(InstrumentId instrument, const OrderGrid& grid);
+
+    // Empty when no grid has been recorded for 'instrument'
+    std::optional<OrderGrid> find(InstrumentId instrument) const;
+
+private:
+    mutable std::mutex mutex_;
+    InstrumentTable<OrderGrid> grids_;
+};
+
+#endif
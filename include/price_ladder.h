@@ -0,0 +1,103 @@
+#ifndef PRICE_LADDER_H
+#define PRICE_LADDER_H
+
+#include <cstdint>
+#include <vector>
+#include "fixed_point.h"
+
+// What a market order of a given amount would take from one side
+struct SweepResult {
+    double filled = 0.0;         // less than asked for when the side runs out
+    double tick_notional = 0.0;  // sum of amount * price, prices in ticks
+    Price worst;                 // last level reached
+
+    double average_ticks() const { return filled > 0.0 ? tick_notional / filled : 0.0; }
+};
+
+// One side of a book as a flat array of amounts indexed by tick offset:
+// level i holds the amount resting at Price(base_tick + i). Prices are
+// integer ticks (see fixed_point.h), so indexing involves no float rounding.
+// Updates are an index computation and a store; the best level index is
+// cached, so top-of-book is a read of a few adjacent fields.
+//
+// The hot fields sit together at the start of a cache-aligned object, so
+// best_price()/best_amount() touch a single cache line.
+//
+// Depth queries (sweep, depth_within) sum the level array 32 levels at a
+// time with AVX2 (SSE2 otherwise), empty levels included, so their cost
+// depends on how many ticks they span rather than on branching per level.
+//
+// The window starts at 'levels' ticks. A level arriving outside it moves
+// the window (in place) or, when the side spans more ticks than the window
+// holds, doubles it, so no level is ever dropped. Only a side wider than
+// kMaxLevels ticks cannot be held: its outlying levels are dropped and
+// truncated() reports it until the next clear().
+class alignas(64) PriceLadder {
+public:
+    enum class Side { Bid, Ask };
+
+    static constexpr int64_t kMaxLevels = int64_t{1} << 22;
+
+    explicit PriceLadder(Side side, size_t levels = 4096);
+
+    void clear();
+
+    // amount == 0 removes the level
+    void set(Price price, double amount);
+
+    bool empty() const { return best_ < 0; }
+    Price best_price() const { return price_at(best_); }
+    double best_amount() const { return best_amount_; }
+
+    // Walks from the best level away from the spread; fn(price, amount)
+    // returns false to stop
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        if (best_ < 0) return;
+        int64_t step = side_ == Side::Bid ? -1 : 1;
+        for (int64_t i = best_; i >= 0 && i < size(); i += step) {
+            double amount = amounts_[static_cast<size_t>(i)];
+            if (amount != 0.0 && !fn(price_at(i), amount)) {
+                return;
+            }
+        }
+    }
+
+    // Walks from the best level until 'amount' is filled, taking part of
+    // the last level reached
+    SweepResult sweep(double amount) const;
+    // Total amount resting within 'ticks' of the best level, best included
+    double depth_within(int64_t ticks) const;
+
+    size_t level_count() const { return count_; }
+    // A level was dropped since the last clear(): the side no longer
+    // matches the feed
+    bool truncated() const { return truncated_; }
+    // Raw level array and the index of its best level (-1 when empty),
+    // ordered from low to high price on both sides
+    const double* data() const { return amounts_.data(); }
+    int64_t best_index() const { return best_; }
+    int64_t size() const { return static_cast<int64_t>(amounts_.size()); }
+    int64_t base_tick() const { return base_tick_; }
+
+private:
+    Price price_at(int64_t index) const { return Price(base_tick_ + index); }
+    bool better(int64_t a, int64_t b) const { return side_ == Side::Bid ? a > b : a < b; }
+
+    // Moves or grows the window to include 'tick'; false past kMaxLevels
+    bool cover(int64_t tick);
+    void shift(int64_t delta);
+    void find_next_best();
+
+    // Top-of-book state: keep these first and together
+    int64_t best_ = -1;
+    double best_amount_ = 0.0;
+    int64_t base_tick_ = 0;
+    Side side_;
+
+    size_t count_ = 0;
+    bool truncated_ = false;
+    std::vector<double> amounts_;
+};
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include "json.hpp"
+
+using json = nlohmann::json;
+
+// Client-side model of Deribit's credit buckets.
+// Every request spends 'cost' credits from its pool and each pool refills at
+// a fixed rate up to its maximum. Spending locally first means a burst is
+// slowed down here instead of being rejected with too_many_requests.
+//
+// Cancels come first: other requests leave 'cancel_reserve' credits in the
+// bucket, and a request is only granted credits when no request of a higher
+// priority is waiting on the same pool. Waiting means blocked in acquire(),
+// or queued by an asynchronous client that registered it with add_waiter(),
+// so priorities hold across every client sharing the limiter.
+class RateLimiter {
+public:
+    enum class Pool : uint8_t { MatchingEngine, NonMatchingEngine };
+    enum class Priority : uint8_t { Cancel, Edit, Order, Other };  // served in this order
+
+    struct Bucket {
+        int64_t max_credits;
+        int64_t refill_per_second;
+        int64_t cost;            // credits per request
+        int64_t cancel_reserve;  // credits only a cancel may spend
+    };
+
+    // Deribit's default per-account limits
+    static constexpr Bucket kMatchingEngine{20000, 5000, 1000, 1000};
+    static constexpr Bucket kNonMatchingEngine{50000, 10000, 500, 0};
+
+    struct Class {
+        Pool pool;
+        Priority priority;
+    };
+
+    RateLimiter();
+    RateLimiter(Bucket matching_engine, Bucket non_matching_engine);
+
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    // Takes the credits if they are available now
+    bool try_acquire(Class request);
+    // Blocks until the credits are available
+    void acquire(Class request);
+    // Time until try_acquire(request) can succeed, zero when it can now
+    std::chrono::nanoseconds wait_time(Class request);
+
+    // For clients that queue requests instead of blocking: a registered
+    // request outranks lower priorities everywhere until it either gets its
+    // credits with try_acquire_waiter() or is given up with remove_waiter()
+    void add_waiter(Class request);
+    bool try_acquire_waiter(Class request);
+    void remove_waiter(Class request);
+
+    // The server rejected a request anyway: its bucket is emptier than ours,
+    // so drain ours and let the refill rate pace the retry
+    void on_rejected(Pool pool);
+
+    int64_t credits(Pool pool);
+
+    // "private/cancel" or a full ".../api/v2/private/cancel" URL
+    static Class classify(std::string_view method);
+    // Deribit error 10028 too_many_requests
+    static bool is_rate_limited(const json& response);
+    static bool is_rate_limited_raw(std::string_view response);  // same, on the unparsed body
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct State {
+        Bucket bucket;
+        int64_t credits;
+        Clock::time_point updated;
+        int waiting[4] = {0, 0, 0, 0};  // blocked acquire() calls and registered waiters per Priority
+    };
+
+    State& state(Pool pool) { return pools_[static_cast<int>(pool)]; }
+    void refill(State& s, Clock::time_point now);
+    int64_t required(const State& s, Priority priority) const;
+    bool outranked(const State& s, Priority priority) const;
+    std::chrono::nanoseconds time_to(const State& s, int64_t credits) const;
+
+    std::mutex mutex_;
+    std::condition_variable released_;
+    State pools_[2];
+};
+
+#endif
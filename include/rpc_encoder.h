@@ -0,0 +1,55 @@
+#ifndef RPC_ENCODER_H
+#define RPC_ENCODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "fixed_point.h"
+
+// Allocation-free JSON-RPC encoder for the order entry methods.
+// Each method is a fixed template whose constant fragments are copied as-is;
+// only the variable fields (id, instrument, amount, price, order_id) are
+// formatted, straight into a buffer owned by the encoder. The returned view
+// points into that buffer and stays valid until the next call.
+// An empty view means the request did not fit.
+class RpcEncoder {
+public:
+    static constexpr size_t kCapacity = 512;
+
+    std::string_view buy(uint64_t id, std::string_view instrument, int amount, std::string_view type, double price);
+    std::string_view sell(uint64_t id, std::string_view instrument, int amount, std::string_view type, double price);
+    std::string_view edit(uint64_t id, std::string_view order_id, int amount, double price);
+    std::string_view cancel(uint64_t id, std::string_view order_id);
+
+    // Exact decimal variants: the digits written are exactly those of the
+    // fixed-point value (FixedScale::to_decimal), with no float formatting
+    std::string_view buy(uint64_t id, std::string_view instrument, Decimal amount, std::string_view type, Decimal price);
+    std::string_view sell(uint64_t id, std::string_view instrument, Decimal amount, std::string_view type, Decimal price);
+    std::string_view edit(uint64_t id, std::string_view order_id, Decimal amount, Decimal price);
+
+private:
+    template <typename Amount, typename Number>
+    std::string_view order(std::string_view method_fragment, uint64_t id, std::string_view instrument,
+                           Amount amount, std::string_view type, Number price);
+    template <typename Amount, typename Number>
+    std::string_view edit_order(uint64_t id, std::string_view order_id, Amount amount, Number price);
+
+    // Writers advance pos_ and flip ok_ off instead of overrunning the buffer
+    void put(std::string_view fragment);
+    void put_string(std::string_view value);  // JSON-escaped, without quotes
+    void put_uint(uint64_t value);
+    void put_int(int value);
+    void put_double(double value);
+    void put_decimal(Decimal value);
+    void put_number(int value) { put_int(value); }
+    void put_number(double value) { put_double(value); }
+    void put_number(Decimal value) { put_decimal(value); }
+    void begin(uint64_t id, std::string_view method_fragment);
+    std::string_view finish();
+
+    char buf_[kCapacity];
+    size_t pos_ = 0;
+    bool ok_ = true;
+};
+
+#endif
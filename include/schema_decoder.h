@@ -0,0 +1,173 @@
+#ifndef SCHEMA_DECODER_H
+#define SCHEMA_DECODER_H
+
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "json_index.h"
+
+// Typed decoding of JSON-RPC responses, without a DOM.
+// A struct opts in by specialising Schema<T> with a constexpr tuple that
+// maps JSON keys to data members:
+//
+//   template <> struct Schema<Position> {
+//       static constexpr auto fields = std::make_tuple(
+//           field("instrument_name", &Position::instrument_name),
+//           field("size", &Position::size));
+//   };
+//
+// Key hashes are computed at compile time. decode() walks the members of
+// the object in a JsonIndex, hashes each key once and compares it against
+// the precomputed hashes; the fold below unrolls into a chain of integer
+// compares, with a string compare only on a hash hit. Unknown keys are
+// skipped without being parsed. Members may be strings, integers, doubles,
+// bools, other schema types and vectors of those. A schema that sets
+// 'positional = true' is read from an array, one field per element
+// ([price, amount] book levels).
+//
+// A member whose JSON value has the wrong type (a null price, say) keeps
+// its default; decode() only fails when the value it was given is not of
+// the expected kind.
+
+constexpr uint64_t key_hash(std::string_view key) {
+    uint64_t hash = 14695981039346656037ULL;  // FNV-1a
+    for (char c : key) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+template <typename T, typename M>
+struct Field {
+    std::string_view key;
+    uint64_t hash;
+    M T::*member;
+};
+
+template <typename T, typename M>
+constexpr Field<T, M> field(std::string_view key, M T::*member) {
+    return {key, key_hash(key), member};
+}
+
+template <typename T>
+struct Schema;
+
+// JSON-RPC error object
+struct RpcError {
+    int64_t code = 0;
+    std::string message;
+};
+
+template <>
+struct Schema<RpcError> {
+    static constexpr auto fields = std::make_tuple(
+        field("code", &RpcError::code),
+        field("message", &RpcError::message));
+};
+
+template <typename T>
+bool decode(const JsonIndex& index, size_t i, T& out);
+
+namespace schema_detail {
+
+template <typename T>
+struct is_vector : std::false_type {};
+template <typename T, typename A>
+struct is_vector<std::vector<T, A>> : std::true_type {};
+
+template <typename T, typename = void>
+struct is_positional : std::false_type {};
+template <typename T>
+struct is_positional<T, std::enable_if_t<Schema<T>::positional>> : std::true_type {};
+
+template <typename T>
+constexpr size_t field_count = std::tuple_size_v<std::decay_t<decltype(Schema<T>::fields)>>;
+
+// Unescapes a quoted JSON string into 'out'
+bool decode_string(std::string_view quoted, std::string& out);
+
+template <typename T, size_t... I>
+void decode_member(const JsonIndex& index, size_t value, std::string_view key, T& out, std::index_sequence<I...>) {
+    constexpr auto& fields = Schema<T>::fields;
+    uint64_t hash = key_hash(key);
+    (void)((std::get<I>(fields).hash == hash && std::get<I>(fields).key == key &&
+            (decode(index, value, out.*(std::get<I>(fields).member)), true)) || ...);
+}
+
+template <typename T, size_t... I>
+void decode_element(const JsonIndex& index, size_t value, size_t position, T& out, std::index_sequence<I...>) {
+    constexpr auto& fields = Schema<T>::fields;
+    (void)((position == I && (decode(index, value, out.*(std::get<I>(fields).member)), true)) || ...);
+}
+
+}  // namespace schema_detail
+
+template <typename T>
+bool decode(const JsonIndex& index, size_t i, T& out) {
+    if (i >= index.size()) {
+        return false;
+    }
+    char kind = index.first_char(i);
+    if constexpr (std::is_same_v<T, std::string>) {
+        return kind == '"' && schema_detail::decode_string(index.value_text(i), out);
+    } else if constexpr (std::is_same_v<T, bool>) {
+        if (kind != 't' && kind != 'f') return false;
+        out = kind == 't';
+        return true;
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        std::string_view text = index.value_text(i);
+        T value{};
+        auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec != std::errc() || end != text.data() + text.size()) return false;
+        out = value;
+        return true;
+    } else if constexpr (schema_detail::is_vector<T>::value) {
+        out.clear();
+        return index.for_each_element(i, [&](size_t element) {
+            out.emplace_back();
+            decode(index, element, out.back());
+            return true;
+        });
+    } else if constexpr (schema_detail::is_positional<T>::value) {
+        size_t position = 0;
+        return index.for_each_element(i, [&](size_t element) {
+            schema_detail::decode_element(index, element, position++, out,
+                                          std::make_index_sequence<schema_detail::field_count<T>>());
+            return position < schema_detail::field_count<T>;
+        });
+    } else {
+        return index.for_each_member(i, [&](std::string_view key, size_t value) {
+            schema_detail::decode_member(index, value, key, out,
+                                         std::make_index_sequence<schema_detail::field_count<T>>());
+            return true;
+        });
+    }
+}
+
+// Builds 'index' over a JSON-RPC response and returns the entry of its
+// "result"; index.size() when the response is malformed, has no result or
+// carries an error (copied to 'error')
+size_t locate_result(JsonIndex& index, std::string_view body, RpcError& error);
+
+// Like locate_result(), then decodes the result into 'result'. False when
+// there is no result or it is not of the expected kind.
+template <typename T>
+bool decode_response(JsonIndex& index, std::string_view body, T& result, RpcError& error) {
+    size_t result_at = locate_result(index, body, error);
+    if (result_at == index.size()) {
+        return false;
+    }
+    if (!decode(index, result_at, result)) {
+        error.message = "Unexpected result";
+        return false;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer sequence lock over a trivially copyable value.
+// The writer never waits: store() bumps the sequence to odd, copies the
+// value in and bumps it to even again. Readers copy the value out and retry
+// when the sequence was odd or moved meanwhile, so they never block the
+// writer or each other and never see a torn value. Reads cost one copy of
+// T plus two loads of the sequence; keep T small (a few cache lines).
+//
+// The value is held as relaxed atomic words, so concurrent copies are not
+// data races; on x86-64 these compile to plain loads and stores.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock values are copied as bytes");
+
+public:
+    SeqLock() = default;
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    // Writer thread only
+    void store(const T& value) {
+        uint64_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        uint64_t words[kWords] = {};
+        std::memcpy(words, &value, sizeof(T));
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    // One attempt; false when a store overlapped it
+    bool try_load(T& out) const {
+        uint64_t before = seq_.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+        uint64_t words[kWords];
+        for (size_t i = 0; i < kWords; ++i) {
+            words[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        std::memcpy(&out, words, sizeof(T));
+        return true;
+    }
+
+    // Retries until a consistent copy is read
+    T load() const {
+        T out;
+        while (!try_load(out)) {
+        }
+        return out;
+    }
+
+    // Completed stores so far; changes whenever the value does
+    uint64_t version() const { return seq_.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint64_t> seq_{0};
+    alignas(64) std::atomic<uint64_t> words_[kWords] = {};
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef SHARDED_FEED_H
+#define SHARDED_FEED_H
+
+#include <boost/asio.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "websocket_client.h"
+
+// Market data spread over several WebSocket connections.
+// Each shard is one WebSocketClient on its own io_context, run by its own
+// thread pinned to one CPU. A channel goes to the shard of its instrument,
+// picked by a fixed hash of the name, so every update of an instrument is
+// read, decoded and handled in order on the same thread, while different
+// instruments are processed in parallel.
+//
+// Handlers run on the shard thread. Anything that keeps per-instrument state
+// (an OrderBookManager, say) should live on that shard: build it on
+// shard(shard_of(instrument)).
+class ShardedFeed {
+public:
+    using ChannelHandler = WebSocketClient::ChannelHandler;
+    using EventHandler = WebSocketClient::EventHandler;
+
+    // 'cpus' lists the core for each shard; when empty, shard i goes to
+    // core i + 1 (modulo the core count), leaving core 0 to the caller
+    explicit ShardedFeed(size_t shards, std::vector<int> cpus = {});
+    ~ShardedFeed();
+
+    ShardedFeed(const ShardedFeed&) = delete;
+    ShardedFeed& operator=(const ShardedFeed&) = delete;
+
+    // Call before connect(): shard threads spin on their io_context instead
+    // of sleeping (see low_latency.h) and sockets get SO_BUSY_POLL with
+    // 'busy_poll'. Every shard then owns its core outright, so give each one
+    // an isolated CPU in 'cpus'.
+    void enable_spin_mode(std::chrono::microseconds busy_poll = std::chrono::microseconds(50));
+
+    // Starts the shard threads; each one connects its own socket. Blocks
+    // until all are connected and rethrows the first connection error.
+    void connect(const std::string& host, const std::string& port, const std::string& path);
+
+    // Groups channels by shard and sends one subscribe request per shard
+    void subscribe(const std::vector<std::string>& channels, ChannelHandler handler);
+    void subscribe_events(const std::vector<std::string>& channels, EventHandler handler);
+    void unsubscribe(const std::vector<std::string>& channels);
+
+    // Stops the io_contexts and joins the threads
+    void stop();
+
+    size_t size() const { return shards_.size(); }
+    size_t shard_of(std::string_view instrument) const;
+    WebSocketClient& shard(size_t index) { return shards_[index]->client; }
+
+    // Shard with the lowest median probe round trip (see
+    // WebSocketClient::start_latency_probe); 0 before any probe has returned
+    size_t fastest_shard() const;
+
+    // "book.BTC-PERPETUAL.raw" -> "BTC-PERPETUAL", "user.orders.ETH-PERPETUAL.raw" -> "ETH-PERPETUAL";
+    // empty for kind/currency channels, which are then sharded by channel
+    static std::string_view instrument_of(std::string_view channel);
+
+private:
+    struct Shard {
+        io_context ioc{1};  // one thread per context, no internal locking needed
+        executor_work_guard<io_context::executor_type> work{make_work_guard(ioc)};
+        WebSocketClient client{ioc};
+        std::thread thread;
+        int cpu = -1;
+    };
+
+    std::vector<std::vector<std::string>> split(const std::vector<std::string>& channels) const;
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    bool spin_ = false;
+};
+
+#endif
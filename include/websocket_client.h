@@ -4,24 +4,191 @@
 #include <boost/asio.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/websocket.hpp>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "binary_event.h"
+#include "book_subscription.h"
+#include "feed_decoder.h"
+#include "instrument_registry.h"
+#include "json_index.h"
+#include "latency_histogram.h"
 #include "json.hpp"
 
 using json = nlohmann::json;
 using namespace boost::asio;
 using namespace boost::beast;
 
+// Event-driven Deribit WebSocket client.
+// Reads and writes are asynchronous operations on the caller's io_context, so
+// one thread running ioc.run() serves every subscribed channel, the responses
+// to our requests and all outgoing frames. Handlers run on that thread.
+//
+// A dropped connection is re-established in the background with exponential
+// backoff (first retry immediately, then 50ms doubling up to 5s), reusing the
+// resolved endpoints. Once the handshake completes, connection handlers see
+// Reconnected (e.g. to send public/auth again), then every active channel is
+// resubscribed in one batched request. Frames queued before the drop are
+// discarded; frames sent while disconnected go out after the resubscription.
+//
+// With a heartbeat enabled, Deribit's test_request heartbeats are answered
+// with public/test automatically, and a connection that has received nothing
+// for two intervals is treated as half-open and dropped (then reconnected).
+// The latency probe sends public/test periodically and records the round
+// trip of each answer in latency().
 class WebSocketClient {
 public:
+    enum class ConnectionEvent { Disconnected, Reconnected };
+
+    using MessageHandler = std::function<void(std::string_view)>;
+    using ChannelHandler = std::function<void(const Notification&)>;
+    using EventHandler = std::function<void(const EventBuffer&)>;
+    using ConnectionHandler = std::function<void(ConnectionEvent)>;
+
     WebSocketClient(io_context& ioc);
 
+    // Blocking connect + handshake, then starts the asynchronous read loop
     void connect(const std::string& host, const std::string& port, const std::string& path);
+
+    // SO_BUSY_POLL for the socket (Linux): a read that finds no data spins
+    // on the device queue for up to 'budget' before sleeping. Set it before
+    // connect(); reconnects keep it. Values above net.core.busy_read need
+    // CAP_NET_ADMIN. Pair with run_spinning() on a pinned thread.
+    void set_busy_poll(std::chrono::microseconds budget) { busy_poll_ = budget; }
+
+    // Every handler is told about drops and completed reconnects. Returns
+    // an id for remove_connection_handler(); an object that registers a
+    // handler capturing itself removes it in its destructor.
+    uint64_t add_connection_handler(ConnectionHandler handler);
+    // Safe from any thread. Once it returns the handler is not running and
+    // is never called again; a handler may remove itself or others.
+    void remove_connection_handler(uint64_t id);
+
+    // Subscribes all channels with one request; user.* channels go through
+    // private/subscribe. Notifications for them are decoded by FeedDecoder
+    // and passed to 'handler'; the Notification is only valid during the call.
+    void subscribe(const std::vector<std::string>& channels, ChannelHandler handler);
+    // Same channels as binary records (binary_event.h): each notification
+    // is encoded once and 'handler' gets its records, valid during the call
+    void subscribe_events(const std::vector<std::string>& channels, EventHandler handler);
+    void unsubscribe(const std::vector<std::string>& channels);
+
+    // Print every update, like the original blocking client did. The string
+    // overload keeps the aggregated book.<instrument>.100ms channel.
     void subscribe_order_book(const std::string& instrument);
-    void subscribe_order_updates();
+    void subscribe_order_book(const BookSubscription& spec);
+    void subscribe_order_book(InstrumentId instrument);
+    void subscribe_order_updates(const std::string& instrument = "BTC-PERPETUAL");
+
+    // Queues one text frame; safe to call from any thread. On the io_context
+    // thread the frame is queued before send() returns.
+    void send(std::string_view message);
+
+    // Frames that are not subscription notifications (responses, heartbeats).
+    // The view points into the read buffer and is only valid during the call.
+    void set_message_handler(MessageHandler handler);
+
+    // JSON-RPC ids shared by everything written to this socket
+    uint64_t next_request_id() { return next_id_.fetch_add(1, std::memory_order_relaxed); }
+
+    // public/set_heartbeat with 'interval' (10s minimum), sent again after
+    // every reconnect, plus the half-open watchdog
+    void enable_heartbeat(std::chrono::seconds interval);
+
+    // One public/test every 'period'; a probe still unanswered when the next
+    // one is due is dropped from the histogram
+    void start_latency_probe(std::chrono::milliseconds period);
+
+    // Round trips of the latency probe; readable from any thread
+    const LatencyHistogram& latency() const { return latency_; }
+
+    // Closes the socket for good; no reconnect follows
+    void close();
+
+    // The io_context the handlers run on; post to it to share their thread
+    io_context& context() { return ioc_; }
 
 private:
+    void do_read();
+    void on_read(uint64_t session, error_code ec, std::size_t bytes);
+    void enqueue(std::string frame);
+    void do_write();
+    void on_write(uint64_t session, error_code ec, std::size_t bytes);
+    void dispatch(std::string_view message);
+    using ChannelMap = std::unordered_map<std::string, ChannelHandler>;
+    void add_route(const ChannelMap::value_type& entry);
+    void remove_route(const ChannelMap::value_type& entry);
+    const ChannelHandler* route(const Notification& notification) const;
+    void send_subscribe(const char* method, const std::vector<std::string>& channels);
+    void resubscribe_all();
+
+    void configure_socket(ip::tcp::socket& socket);
+    void on_connection_lost(error_code ec);
+    void schedule_reconnect();
+    void reconnect();
+    void on_reconnect_failed(error_code ec);
+    void on_connected(bool reconnected);
+    void notify(ConnectionEvent event);
+
+    bool handle_control(std::string_view message);
+    void send_heartbeat_request();
+    void schedule_watchdog();
+    void schedule_probe();
+
+    io_context& ioc_;
     ip::tcp::resolver resolver_;
-    websocket::stream<ip::tcp::socket> ws_;
-    void listen();
+    std::optional<websocket::stream<ip::tcp::socket>> ws_;  // replaced on every reconnect
+    std::atomic<uint64_t> next_id_{1};
+
+    // Owned by the io_context thread
+    std::string host_, port_, path_;
+    ip::tcp::resolver::results_type endpoints_;  // cached for reconnects
+    steady_timer reconnect_timer_;
+    std::chrono::microseconds busy_poll_{0};
+    std::chrono::milliseconds backoff_{0};
+    uint64_t session_ = 0;  // completions of an older socket are ignored
+    bool connected_ = false;
+    bool closing_ = false;
+    bool writing_ = false;
+
+    flat_buffer read_buffer_;  // reused for every frame, keeps its capacity
+    FeedDecoder decoder_;
+    Notification notification_;
+    EventBuffer events_;  // records of the notification being dispatched
+    std::deque<std::string> write_queue_;
+    // Queues of dropped sockets whose last async_write has not completed
+    // yet; kept alive because that write still points into the front frame
+    std::deque<std::deque<std::string>> retired_queues_;
+    ChannelMap channels_;  // every subscribed channel
+    // Entries of channels_ that name one instrument, by its id: dispatch
+    // compares the channel with the one or two subscribed for the
+    // notification's instrument instead of hashing it
+    InstrumentTable<std::vector<const ChannelMap::value_type*>> routes_;
+    MessageHandler handler_;
+    // Held while handlers run, so a removal waits for a call in progress;
+    // recursive so that handlers can add and remove handlers
+    std::recursive_mutex connection_mutex_;
+    std::map<uint64_t, ConnectionHandler> connection_handlers_;
+    uint64_t next_handler_id_ = 1;
+
+    // Heartbeat and latency probe
+    JsonIndex control_index_;  // responses and heartbeats, looked up in place
+    std::chrono::steady_clock::time_point last_received_;
+    std::chrono::seconds heartbeat_interval_{0};
+    steady_timer watchdog_timer_;
+    std::chrono::milliseconds probe_period_{0};
+    steady_timer probe_timer_;
+    uint64_t probe_id_ = 0;  // outstanding probe, 0 when none
+    std::chrono::steady_clock::time_point probe_sent_;
+    LatencyHistogram latency_;
 };
 
-#endif // WEBSOCKET_CLIENT_H
\ No newline at end of file
+#endif // WEBSOCKET_CLIENT_H
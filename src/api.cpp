@@ -16,21 +16,57 @@ size_t WriteCallback(void* ptr, size_t size, size_t nmemb, void* userdata) {
     return size * nmemb;
 }
 
-json API::send_post_request(const std::string& url, const json& data, const std::string& access_token) {
-    std::unique_ptr<CURL, decltype(&curl_easy_cleanup)> curl(curl_easy_init(), curl_easy_cleanup);
+// Transport failures look like server errors to the decoders
+static std::string error_response(const std::string& message) {
+    return json{{"error", {{"code", -1}, {"message", message}}}}.dump();
+}
+
+const ArenaJson& API::send_post_request(const std::string& url, const json& data, const std::string& access_token) {
+    std::string json_data = data.dump();
+    std::string body = send_raw_request(url, json_data, access_token);
+
+    // ✅ Drop the previous tree while its memory is still valid, then reuse the arena
+    response = ArenaJson();
+    response_arena.reset();
+    ResponseArena::Scope scope(response_arena);
+    response = ArenaJson::parse(body, nullptr, false);
+    if (response.is_discarded()) {
+        response = {{"error", "JSON Parse Error"}, {"raw_response", body}};
+    }
+    return response;
+}
+
+std::string API::send_raw_request(const std::string& url, std::string_view body, const std::string& access_token) {
+    RateLimiter::Class request_class = RateLimiter::classify(url);
+    limiter.acquire(request_class);
+    std::string response = perform_request(url, body, access_token);
+
+    // ✅ Our bucket was ahead of the server's: resync it and retry once when credits are back
+    if (RateLimiter::is_rate_limited_raw(response)) {
+        limiter.on_rejected(request_class.pool);
+        limiter.acquire(request_class);
+        response = perform_request(url, body, access_token);
+    }
+    return response;
+}
+
+std::string API::perform_request(const std::string& url, std::string_view body, const std::string& access_token) {
+    CurlPool::Handle curl = pool.acquire(url);
     if (!curl) {
-        return {{"error", "CURL initialization failed"}};
+        return error_response("CURL initialization failed");
     }
 
-    std::string json_data = data.dump();
     struct curl_slist* headers = nullptr;
     headers = curl_slist_append(headers, "Content-Type: application/json");
-    headers = curl_slist_append(headers, ("Authorization: Bearer " + access_token).c_str());
+    if (!access_token.empty()) {
+        headers = curl_slist_append(headers, ("Authorization: Bearer " + access_token).c_str());
+    }
 
     std::string response_string;
     curl_easy_setopt(curl.get(), CURLOPT_URL, url.c_str());
     curl_easy_setopt(curl.get(), CURLOPT_POST, 1L);
-    curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDS, json_data.c_str());
+    curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDS, body.data());
+    curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDSIZE, static_cast<long>(body.size()));
     curl_easy_setopt(curl.get(), CURLOPT_HTTPHEADER, headers);
     curl_easy_setopt(curl.get(), CURLOPT_WRITEFUNCTION, WriteCallback);
     curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &response_string);
@@ -39,26 +75,49 @@ json API::send_post_request(const std::string& url, const json& data, const std:
     curl_slist_free_all(headers);
 
     if (res != CURLE_OK) {
-        return {{"error", curl_easy_strerror(res)}};
+        return error_response(curl_easy_strerror(res));
     }
 
     if (response_string.empty()) {
-        return {{"error", "Empty response"}};
+        return error_response("Empty response");
     }
+    return response_string;
+}
 
-    try {
-        return json::parse(response_string);
-    } catch (const json::parse_error& e) {
-        return {{"error", "JSON Parse Error"}, {"details", e.what()}, {"raw_response", response_string}};
+template <typename T>
+bool API::decode_result(std::string_view body, T& result, const char* what) {
+    RpcError error;
+    if (!decode_response(response_index, body, result, error)) {
+        std::cerr << "❌ " << what << " failed: " << error.message;
+        if (error.code != 0) {
+            std::cerr << " (code " << error.code << ")";
+        }
+        std::cerr << std::endl;
+        return false;
     }
+    return true;
 }
 
-std::string API::authenticate() {
-    std::unique_ptr<CURL, decltype(&curl_easy_cleanup)> curl(curl_easy_init(), curl_easy_cleanup);
-    if (!curl) {
-        return "";
+std::optional<JsonView> API::view_result(std::string body, const char* what) {
+    view_body = std::move(body);
+    RpcError error;
+    size_t result_at = locate_result(response_index, view_body, error);
+    if (result_at == response_index.size()) {
+        std::cerr << "❌ " << what << " failed: " << error.message;
+        if (error.code != 0) {
+            std::cerr << " (code " << error.code << ")";
+        }
+        std::cerr << std::endl;
+        return std::nullopt;
     }
+    return JsonView(response_index, result_at);
+}
+
+void API::warm_up(size_t connections) {
+    pool.warm_up("https://test.deribit.com/api/v2/public/test", connections);
+}
 
+std::string API::authenticate() {
     std::string url = "https://test.deribit.com/api/v2/public/auth";
     json json_data = {
         {"jsonrpc", "2.0"},
@@ -72,173 +131,206 @@ std::string API::authenticate() {
         }}
     };
 
-    std::string post_data = json_data.dump();
-    std::string response;
-    struct curl_slist* headers = curl_slist_append(nullptr, "Content-Type: application/json");
+    std::string response = send_raw_request(url, json_data.dump(), "");
 
-    curl_easy_setopt(curl.get(), CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl.get(), CURLOPT_POST, 1);
-    curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDS, post_data.c_str());
-    curl_easy_setopt(curl.get(), CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl.get(), CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &response);
+    AuthToken token;
+    if (!decode_result(response, token, "Authentication")) {
+        return "";
+    }
+    if (token.access_token.empty()) {
+        std::cerr << "❌ Authentication failed: no access token in the response" << std::endl;
+    }
+    return token.access_token;
+}
 
-    CURLcode res = curl_easy_perform(curl.get());
-    curl_slist_free_all(headers);
+const ArenaJson& API::call(const std::string& method, const json& params, const std::string& access_token) {
+    json json_data = {
+        {"jsonrpc", "2.0"},
+        {"id", 8},
+        {"method", method},
+        {"params", params}
+    };
+    // ✅ Generic response: parsed into the response arena, no heap calls per node
+    return send_post_request("https://test.deribit.com/api/v2/" + method, json_data, access_token);
+}
 
-    if (res != CURLE_OK) {
-        return "";
+std::string API::place_order(const std::string& access_token, const std::string& instrument, int amount, const std::string& type, double price) {
+    return place_order(access_token, InstrumentRegistry::instance().intern(instrument), amount, type, price);
+}
+
+// Tells the user when their input was moved onto the instrument's grid
+static void report_snap(const char* what, double requested, Decimal snapped) {
+    if (to_double(snapped) != requested) {
+        char text[24];
+        size_t length = format_decimal(snapped, text);
+        std::cout << "ℹ️ " << what << " " << requested << " snapped to " << std::string_view(text, length) << std::endl;
     }
+}
 
-    try {
-        json json_response = json::parse(response);
-        if (json_response.contains("result") && json_response["result"].contains("access_token")) {
-            return json_response["result"]["access_token"];
+std::string API::place_order(const std::string& access_token, InstrumentId instrument, int amount, const std::string& type, double price) {
+    bool buy = type == "limit";
+    std::string url = "https://test.deribit.com/api/v2/private/" + std::string(buy ? "buy" : "sell");
+    const std::string& instrument_name = InstrumentRegistry::instance().name(instrument);
+
+    // ✅ Price is only encoded for limit orders
+    std::string_view body;
+    if (std::optional<OrderGrid> grid = order_grid(instrument)) {
+        Decimal snapped_amount = grid->amount(amount);
+        Decimal snapped_price = grid->price(price, buy);
+        if (snapped_amount.mantissa <= 0) {
+            std::cerr << "Error: amount " << amount << " is below the minimum for " << instrument_name << std::endl;
+            return "";
         }
-    } catch (const json::parse_error& e) {
+        report_snap("Amount", amount, snapped_amount);
+        if (type == "limit") {
+            report_snap("Price", price, snapped_price);
+        }
+        body = buy
+            ? encoder.buy(1, instrument_name, snapped_amount, type, snapped_price)
+            : encoder.sell(1, instrument_name, snapped_amount, type, snapped_price);
+    } else {
+        body = buy
+            ? encoder.buy(1, instrument_name, amount, type, price)
+            : encoder.sell(1, instrument_name, amount, type, price);
+    }
+    if (body.empty()) {
+        std::cerr << "Error: order request too large to encode" << std::endl;
         return "";
     }
-    return "";
-}
 
-std::string API::place_order(const std::string& access_token, const std::string& instrument, int amount, const std::string& type, double price) {
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        std::cerr << "Failed to initialize cURL" << std::endl;
+    std::string response = send_raw_request(url, body, access_token);
+
+    // ✅ Debug: Print full response
+    std::cout << "Order Response: " << response << std::endl;
+
+    OrderPlacement placement;
+    if (!decode_result(response, placement, "Order request")) {
         return "";
     }
+    if (placement.order.order_id.empty()) {
+        std::cerr << "Error: 'order_id' missing in response!" << std::endl;
+    }
+    return placement.order.order_id;
+}
 
-    std::string url = "https://test.deribit.com/api/v2/private/" + std::string(type == "limit" ? "buy" : "sell");
+std::optional<Order> API::cancel_order(const std::string &access_token, const std::string &order_id) {
+    std::string url = "https://test.deribit.com/api/v2/private/cancel";
 
-    json json_data = {
-        {"jsonrpc", "2.0"},
-        {"id", 1},
-        {"method", type == "limit" ? "private/buy" : "private/sell"},
-        {"params", {
-            {"instrument_name", instrument},
-            {"amount", amount},
-            {"type", type}  // ✅ Send type explicitly
-        }}
-    };
-    
-    // ✅ Only include price if it's a limit order
-    if (type == "limit") {
-        json_data["params"]["price"] = price;
+    std::string_view body = encoder.cancel(2, order_id);
+    if (body.empty()) {
+        std::cerr << "❌ Error: cancel request too large to encode" << std::endl;
+        return std::nullopt;
     }
-    
 
-    std::string post_data = json_data.dump();
-    
-    std::string response;
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-    headers = curl_slist_append(headers, ("Authorization: Bearer " + access_token).c_str());
+    std::string response = send_raw_request(url, body, access_token);
 
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_POST, 1);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, post_data.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-
-    CURLcode res = curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
-    curl_slist_free_all(headers);
+    // ✅ Print response for debugging
+    std::cout << "Cancel Order Raw Response: " << response << std::endl;
 
-    if (res != CURLE_OK) {
-        std::cerr << "cURL request failed: " << curl_easy_strerror(res) << std::endl;
-        return "";
+    Order order;
+    if (!decode_result(response, order, "Cancel order")) {
+        return std::nullopt;
     }
+    std::cout << "✅ Order " << order.order_id << " is now " << order.order_state << std::endl;
+    return order;
+}
 
-    std::cout << "Raw Order Response: " << response << std::endl;
-
-    try {
-        json json_response = json::parse(response);
+std::optional<OrderPlacement> API::modify_order(const std::string& access_token, const std::string& order_id, int new_amount, double new_price) {
+    // ✅ private/edit names neither the instrument nor the side; without them the new values could not be snapped
+    std::optional<Order> order = get_order_state(access_token, order_id);
+    if (!order) {
+        return std::nullopt;  // an unknown order cannot be edited either
+    }
+    InstrumentId instrument = order->instrument_name.empty()
+        ? kNoInstrument
+        : InstrumentRegistry::instance().intern(order->instrument_name);
+    return modify_order(access_token, order_id, instrument, order->direction == "buy", new_amount, new_price);
+}
 
-        // ✅ Debug: Print full response
-        std::cout << "Parsed Order Response: " << json_response.dump(4) << std::endl;
+std::optional<OrderPlacement> API::modify_order(const std::string& access_token, const std::string& order_id, InstrumentId instrument, bool buy, int new_amount, double new_price) {
+    std::string url = "https://test.deribit.com/api/v2/private/edit";
 
-        // ✅ Check if response contains expected fields
-        if (json_response.contains("result")) {
-            if (json_response["result"].contains("order_id")) {
-                return json_response["result"]["order_id"].get<std::string>();
-            } else if (json_response["result"].contains("order") && json_response["result"]["order"].contains("order_id")) {
-                return json_response["result"]["order"]["order_id"].get<std::string>();
-            }
+    std::string_view body;
+    std::optional<OrderGrid> grid;
+    if (instrument != kNoInstrument) {
+        grid = order_grid(instrument);
+    }
+    if (grid) {
+        Decimal snapped_amount = grid->amount(new_amount);
+        Decimal snapped_price = grid->price(new_price, buy);
+        if (snapped_amount.mantissa <= 0) {
+            std::cerr << "❌ Error: amount " << new_amount << " is below the instrument's minimum" << std::endl;
+            return std::nullopt;
         }
+        report_snap("Amount", new_amount, snapped_amount);
+        report_snap("Price", new_price, snapped_price);
+        body = encoder.edit(3, order_id, snapped_amount, snapped_price);
+    } else {
+        body = encoder.edit(3, order_id, new_amount, new_price);
+    }
+    if (body.empty()) {
+        std::cerr << "❌ Error: edit request too large to encode" << std::endl;
+        return std::nullopt;
+    }
 
-        std::cerr << "Error: 'order_id' missing in response!" << std::endl;
-        return "";
+    std::string response = send_raw_request(url, body, access_token);
 
-    } catch (json::parse_error& e) {
-        std::cerr << "JSON parse error: " << e.what() << "\nResponse: " << response << std::endl;
-        return "";
+    std::cout << "Modify Order Raw Response: " << response << std::endl;
+
+    OrderPlacement placement;
+    if (!decode_result(response, placement, "Modify order")) {
+        return std::nullopt;
     }
+    return placement;
 }
 
-
-json API::cancel_order(const std::string &access_token, const std::string &order_id) {
-    std::string url = "https://test.deribit.com/api/v2/private/cancel";
+std::optional<Order> API::get_order_state(const std::string& access_token, const std::string& order_id) {
+    std::string url = "https://test.deribit.com/api/v2/private/get_order_state";
 
     json json_data = {
         {"jsonrpc", "2.0"},
-        {"id", 2},
-        {"method", "private/cancel"},
+        {"id", 7},
+        {"method", "private/get_order_state"},
         {"params", {
             {"order_id", order_id}
         }}
     };
 
-    json response = send_post_request(url, json_data, access_token);
+    std::string response = send_raw_request(url, json_data.dump(), access_token);
 
-    // ✅ Print response for debugging
-    std::cout << "Cancel Order Raw Response: " << response.dump(4) << std::endl;
-
-    // ✅ Handle error cases
-    if (!response.contains("result")) {
-        std::cerr << "❌ Error: 'result' field missing in cancel order response." << std::endl;
-        return {{"error", "Invalid response structure"}};
-    }
-
-    try {
-        std::string canceled_order_id = response["result"]["order_id"];
-        std::string order_state = response["result"]["order_state"];
-        std::cout << "✅ Order " << canceled_order_id << " is now " << order_state << std::endl;
-        return response;
-    } catch (json::exception& e) {
-        std::cerr << "❌ JSON Exception: " << e.what() << std::endl;
-        return {{"error", "JSON parsing failed"}};
+    Order order;
+    if (!decode_result(response, order, "Order state request")) {
+        return std::nullopt;
     }
+    return order;
 }
 
-json API::modify_order(const std::string& access_token, const std::string& order_id, int new_amount, double new_price) {
-    std::string url = "https://test.deribit.com/api/v2/private/edit";
+std::optional<OrderBookSnapshot> API::get_order_book(const std::string& instrument_name) {
+    std::string url = "https://test.deribit.com/api/v2/public/get_order_book";
 
     json json_data = {
         {"jsonrpc", "2.0"},
         {"id", 3},
-        {"method", "private/edit"},
+        {"method", "public/get_order_book"},
         {"params", {
-            {"order_id", order_id},
-            {"amount", new_amount},
-            {"price", new_price}
+            {"instrument_name", instrument_name},
+            {"depth", 10}  // Get top 10 bids/asks
         }}
     };
 
-    json response = send_post_request(url, json_data, access_token);
+    std::string response = send_raw_request(url, json_data.dump(), ""); // No access token needed for public API
 
-    std::cout << "Modify Order Raw Response: " << response.dump(4) << std::endl;
+    // Debugging: Print raw response
+    std::cout << "📖 Raw Order Book Response:\n" << response << std::endl;
 
-    // ✅ Ensure response contains "result"
-    if (!response.contains("result")) {
-        std::cerr << "❌ Error: 'result' field missing in modify order response." << std::endl;
-        return {{"error", "Invalid response structure"}};
+    OrderBookSnapshot book;
+    if (!decode_result(response, book, "Order book request")) {
+        return std::nullopt;
     }
-
-    return response;
+    return book;
 }
 
-json API::get_order_book(const std::string& instrument_name) {
+std::optional<JsonView> API::get_order_book_view(const std::string& instrument_name, int depth) {
     std::string url = "https://test.deribit.com/api/v2/public/get_order_book";
 
     json json_data = {
@@ -247,27 +339,73 @@ json API::get_order_book(const std::string& instrument_name) {
         {"method", "public/get_order_book"},
         {"params", {
             {"instrument_name", instrument_name},
-            {"depth", 10}  // Get top 10 bids/asks
+            {"depth", depth}
         }}
     };
 
-    json response = send_post_request(url, json_data, ""); // No access token needed for public API
+    return view_result(send_raw_request(url, json_data.dump(), ""), "Order book request");
+}
 
-    // Debugging: Print raw response
-    std::cout << "📖 Raw Order Book Response:\n" << response.dump(4) << std::endl;
+std::optional<OrderBookSnapshot> API::get_order_book(InstrumentId instrument) {
+    return get_order_book(InstrumentRegistry::instance().name(instrument));
+}
+
+std::optional<InstrumentSpec> API::get_instrument(const std::string& instrument_name) {
+    std::string url = "https://test.deribit.com/api/v2/public/get_instrument";
+
+    json json_data = {
+        {"jsonrpc", "2.0"},
+        {"id", 6},
+        {"method", "public/get_instrument"},
+        {"params", {
+            {"instrument_name", instrument_name}
+        }}
+    };
 
-    // ✅ Validate response
-    if (!response.contains("result")) {
-        std::cerr << "❌ Error: Failed to retrieve order book!\n";
-        return {{"error", "Invalid response"}};
+    std::string response = send_raw_request(url, json_data.dump(), "");
+
+    InstrumentSpec spec;
+    if (!decode_result(response, spec, "Instrument request")) {
+        return std::nullopt;
+    }
+    if (spec.tick_size > 0.0 && spec.min_trade_amount > 0.0) {
+        InstrumentId id = InstrumentRegistry::instance().intern(instrument_name);
+        grids.set(id, OrderGrid{FixedScale::from_double(spec.tick_size),
+                                FixedScale::from_double(spec.min_trade_amount)});
+    }
+    return spec;
+}
+
+std::optional<OrderGrid> API::order_grid(InstrumentId instrument) {
+    if (std::optional<OrderGrid> grid = grids.find(instrument)) {
+        return grid;
     }
+    get_instrument(InstrumentRegistry::instance().name(instrument));
+    return grids.find(instrument);
+}
 
-    json result = response["result"];
+std::optional<Ticker> API::get_ticker(const std::string& instrument_name) {
+    std::string url = "https://test.deribit.com/api/v2/public/ticker";
 
-    return result;
+    json json_data = {
+        {"jsonrpc", "2.0"},
+        {"id", 5},
+        {"method", "public/ticker"},
+        {"params", {
+            {"instrument_name", instrument_name}
+        }}
+    };
+
+    std::string response = send_raw_request(url, json_data.dump(), "");
+
+    Ticker ticker;
+    if (!decode_result(response, ticker, "Ticker request")) {
+        return std::nullopt;
+    }
+    return ticker;
 }
 
-json API::get_current_positions(const std::string& access_token) {
+std::optional<std::vector<Position>> API::get_current_positions(const std::string& access_token) {
     std::string url = "https://test.deribit.com/api/v2/private/get_positions";
 
     json json_data = {
@@ -279,36 +417,29 @@ json API::get_current_positions(const std::string& access_token) {
         }}
     };
 
-    json response = send_post_request(url, json_data, access_token);
+    std::string response = send_raw_request(url, json_data.dump(), access_token);
 
     // 🛠 Validate response
-    if (!response.contains("result")) {
-        std::cerr << "❌ Error: Unable to fetch positions.\n";
-        return {{"error", "Invalid response"}};
+    std::vector<Position> positions;
+    if (!decode_result(response, positions, "Positions request")) {
+        return std::nullopt;
     }
 
-    json positions = response["result"];
-
     // 📊 Display summary
     std::cout << "\n📌 **Open Positions Summary**\n";
     if (positions.empty()) {
         std::cout << "✅ No open positions.\n";
     } else {
         for (const auto& pos : positions) {
-            std::string instrument = pos.value("instrument_name", "N/A");
-            double size = pos.value("size", 0.0);
-            double entry_price = pos.value("average_price", 0.0);
-            double mark_price = pos.value("mark_price", 0.0);
-            double unrealized_pnl = pos.value("floating_profit_loss", 0.0);
-            std::string direction = (size > 0) ? "LONG 🟢" : "SHORT 🔴";
+            std::string direction = (pos.size > 0) ? "LONG 🟢" : "SHORT 🔴";
 
             std::cout << "--------------------------------------\n";
-            std::cout << "📍 Instrument: " << instrument << "\n";
-            std::cout << "📏 Size: " << size << " contracts (" << direction << ")\n";
-            std::cout << "🎯 Entry Price: " << entry_price << "\n";
-            std::cout << "📊 Mark Price: " << mark_price << "\n";
+            std::cout << "📍 Instrument: " << (pos.instrument_name.empty() ? "N/A" : pos.instrument_name) << "\n";
+            std::cout << "📏 Size: " << pos.size << " contracts (" << direction << ")\n";
+            std::cout << "🎯 Entry Price: " << pos.average_price << "\n";
+            std::cout << "📊 Mark Price: " << pos.mark_price << "\n";
             std::cout << "💰 Unrealized PnL: " 
-                      << (unrealized_pnl >= 0 ? "🟢 " : "🔴 ") << unrealized_pnl << "\n";
+                      << (pos.floating_profit_loss >= 0 ? "🟢 " : "🔴 ") << pos.floating_profit_loss << "\n";
         }
         std::cout << "--------------------------------------\n";
     }
@@ -0,0 +1,41 @@
+#include "../include/arena_json.h"
+#include <new>
+
+namespace {
+
+thread_local std::pmr::memory_resource* current_resource = nullptr;
+
+// Each block starts with the resource it came from (nullptr: global heap),
+// padded to keep the payload max-aligned
+constexpr size_t kHeader = alignof(std::max_align_t);
+
+}  // namespace
+
+ResponseArena::ResponseArena(size_t initial_bytes)
+    : buffer_(new std::byte[initial_bytes]),
+      resource_(buffer_.get(), initial_bytes, std::pmr::new_delete_resource()) {}
+
+ResponseArena::Scope::Scope(ResponseArena& arena) : previous_(current_resource) {
+    current_resource = arena.resource();
+}
+
+ResponseArena::Scope::~Scope() {
+    current_resource = previous_;
+}
+
+void* arena_detail::allocate(size_t bytes) {
+    std::pmr::memory_resource* owner = current_resource;
+    void* block = owner ? owner->allocate(kHeader + bytes, kHeader) : ::operator new(kHeader + bytes);
+    *static_cast<std::pmr::memory_resource**>(block) = owner;
+    return static_cast<std::byte*>(block) + kHeader;
+}
+
+void arena_detail::deallocate(void* p, size_t bytes) noexcept {
+    void* block = static_cast<std::byte*>(p) - kHeader;
+    std::pmr::memory_resource* owner = *static_cast<std::pmr::memory_resource**>(block);
+    if (owner) {
+        owner->deallocate(block, kHeader + bytes, kHeader);  // a no-op for the monotonic arena
+    } else {
+        ::operator delete(block);
+    }
+}
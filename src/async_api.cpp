@@ -0,0 +1,367 @@
+#include "../include/async_api.h"
+#include "../include/rpc_encoder.h"
+#include <algorithm>
+#include <iostream>
+
+static size_t AsyncWriteCallback(void* ptr, size_t size, size_t nmemb, void* userdata) {
+    auto* response = static_cast<std::string*>(userdata);
+    if (!response) return 0;
+    response->append(static_cast<char*>(ptr), size * nmemb);
+    return size * nmemb;
+}
+
+// Wraps a promise in a callback so both submission styles share one path
+static AsyncAPI::Callback make_promise_callback(std::future<json>& future) {
+    auto promise = std::make_shared<std::promise<json>>();
+    future = promise->get_future();
+    return [promise](json response) { promise->set_value(std::move(response)); };
+}
+
+AsyncAPI::AsyncAPI() : AsyncAPI(own_limiter_) {}
+
+AsyncAPI::AsyncAPI(RateLimiter& limiter, const OrderGrids& grids) : AsyncAPI(limiter) {
+    grids_ = &grids;
+}
+
+AsyncAPI::AsyncAPI(RateLimiter& limiter) : limiter_(limiter) {
+    multi_ = curl_multi_init();
+    if (!multi_) {
+        std::cerr << "Failed to initialize cURL multi handle" << std::endl;
+        return;
+    }
+    // ✅ Multiplex over HTTP/2 where the server allows it, keep connections warm otherwise
+    curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, 16L);
+
+    running_ = true;
+    thread_ = std::thread(&AsyncAPI::run, this);
+}
+
+AsyncAPI::~AsyncAPI() {
+    running_ = false;
+    if (multi_) {
+        curl_multi_wakeup(multi_);
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    fail_all("AsyncAPI shut down");
+    for (CURL* easy : idle_handles_) {
+        curl_easy_cleanup(easy);
+    }
+    if (multi_) {
+        curl_multi_cleanup(multi_);
+    }
+}
+
+void AsyncAPI::submit(std::unique_ptr<Request> request) {
+    if (!running_) {
+        request->on_done({{"error", "AsyncAPI is not running"}});
+        return;
+    }
+    in_flight_.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        queued_.push_back(std::move(request));
+    }
+    curl_multi_wakeup(multi_);
+}
+
+// Callers may submit from any thread, so each thread encodes into its own buffer
+static thread_local RpcEncoder encoder;
+
+void AsyncAPI::send_post_request(const std::string& url, const json& data, const std::string& access_token, Callback on_done) {
+    send_raw_request(url, data.dump(), access_token, std::move(on_done));
+}
+
+void AsyncAPI::send_raw_request(const std::string& url, std::string_view body, const std::string& access_token, Callback on_done) {
+    enqueue(url, body, access_token, {}, std::move(on_done));
+}
+
+void AsyncAPI::enqueue(const std::string& url, std::string_view body, const std::string& access_token,
+                       std::string_view order_id, Callback on_done) {
+    if (body.empty()) {
+        on_done({{"error", "Request too large to encode"}});
+        return;
+    }
+    auto request = std::make_unique<Request>();
+    request->url = url;
+    request->body.assign(body.data(), body.size());
+    request->order_id.assign(order_id.data(), order_id.size());
+    request->request_class = RateLimiter::classify(url);
+    if (!access_token.empty()) {
+        request->auth_header = "Authorization: Bearer " + access_token;
+    }
+    request->on_done = std::move(on_done);
+    submit(std::move(request));
+}
+
+std::future<json> AsyncAPI::send_post_request(const std::string& url, const json& data, const std::string& access_token) {
+    std::future<json> future;
+    send_post_request(url, data, access_token, make_promise_callback(future));
+    return future;
+}
+
+void AsyncAPI::place_order(const std::string& access_token, const std::string& instrument, int amount, const std::string& type, double price, Callback on_done) {
+    bool buy = type == "limit";
+    std::string url = "https://test.deribit.com/api/v2/private/" + std::string(buy ? "buy" : "sell");
+
+    std::string_view body;
+    std::optional<OrderGrid> grid;
+    if (grids_) {
+        grid = grids_->find(InstrumentRegistry::instance().find(instrument));
+    }
+    if (grid) {
+        Decimal snapped_amount = grid->amount(amount);
+        if (snapped_amount.mantissa <= 0) {
+            on_done({{"error", "Amount below the instrument's minimum"}});
+            return;
+        }
+        body = buy
+            ? encoder.buy(1, instrument, snapped_amount, type, grid->price(price, buy))
+            : encoder.sell(1, instrument, snapped_amount, type, grid->price(price, buy));
+    } else {
+        body = buy
+            ? encoder.buy(1, instrument, amount, type, price)
+            : encoder.sell(1, instrument, amount, type, price);
+    }
+    send_raw_request(url, body, access_token, std::move(on_done));
+}
+
+std::future<json> AsyncAPI::place_order(const std::string& access_token, const std::string& instrument, int amount, const std::string& type, double price) {
+    std::future<json> future;
+    place_order(access_token, instrument, amount, type, price, make_promise_callback(future));
+    return future;
+}
+
+void AsyncAPI::cancel_order(const std::string& access_token, const std::string& order_id, Callback on_done) {
+    enqueue("https://test.deribit.com/api/v2/private/cancel", encoder.cancel(2, order_id), access_token, order_id, std::move(on_done));
+}
+
+std::future<json> AsyncAPI::cancel_order(const std::string& access_token, const std::string& order_id) {
+    std::future<json> future;
+    cancel_order(access_token, order_id, make_promise_callback(future));
+    return future;
+}
+
+void AsyncAPI::modify_order(const std::string& access_token, const std::string& order_id, int new_amount, double new_price, Callback on_done) {
+    enqueue("https://test.deribit.com/api/v2/private/edit", encoder.edit(3, order_id, new_amount, new_price), access_token, order_id, std::move(on_done));
+}
+
+std::future<json> AsyncAPI::modify_order(const std::string& access_token, const std::string& order_id, int new_amount, double new_price) {
+    std::future<json> future;
+    modify_order(access_token, order_id, new_amount, new_price, make_promise_callback(future));
+    return future;
+}
+
+void AsyncAPI::modify_order(const std::string& access_token, const std::string& order_id, InstrumentId instrument, bool buy, int new_amount, double new_price, Callback on_done) {
+    std::optional<OrderGrid> grid;
+    if (grids_) {
+        grid = grids_->find(instrument);
+    }
+    if (!grid) {
+        modify_order(access_token, order_id, new_amount, new_price, std::move(on_done));
+        return;
+    }
+    Decimal snapped_amount = grid->amount(new_amount);
+    if (snapped_amount.mantissa <= 0) {
+        on_done({{"error", "Amount below the instrument's minimum"}});
+        return;
+    }
+    enqueue("https://test.deribit.com/api/v2/private/edit", encoder.edit(3, order_id, snapped_amount, grid->price(new_price, buy)),
+            access_token, order_id, std::move(on_done));
+}
+
+std::future<json> AsyncAPI::modify_order(const std::string& access_token, const std::string& order_id, InstrumentId instrument, bool buy, int new_amount, double new_price) {
+    std::future<json> future;
+    modify_order(access_token, order_id, instrument, buy, new_amount, new_price, make_promise_callback(future));
+    return future;
+}
+
+// Queues a request that is waiting for credits, coalescing edits and cancels
+// of the same order that have not gone out yet
+void AsyncAPI::schedule(std::unique_ptr<Request> request) {
+    using Priority = RateLimiter::Priority;
+    Priority priority = request->request_class.priority;
+    if (!request->order_id.empty() && (priority == Priority::Edit || priority == Priority::Cancel)) {
+        auto& edits = waiting_[static_cast<int>(Priority::Edit)];
+        for (auto it = edits.begin(); it != edits.end();) {
+            if ((*it)->order_id != request->order_id) {
+                ++it;
+                continue;
+            }
+            std::unique_ptr<Request> superseded = std::move(*it);
+            it = edits.erase(it);
+            limiter_.remove_waiter(superseded->request_class);
+            in_flight_.fetch_sub(1, std::memory_order_relaxed);
+            superseded->on_done({{"error", priority == Priority::Edit ? "Superseded by a newer edit" : "Superseded by cancel"}});
+        }
+    }
+    limiter_.add_waiter(request->request_class);
+    waiting_[static_cast<int>(priority)].push_back(std::move(request));
+}
+
+// Starts waiting requests while credits last and returns how long until the
+// next one can go (1s when nothing is waiting)
+std::chrono::milliseconds AsyncAPI::start_queued() {
+    std::vector<std::unique_ptr<Request>> batch;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        batch.swap(queued_);
+    }
+    for (auto& request : batch) {
+        schedule(std::move(request));
+    }
+
+    auto next = std::chrono::milliseconds(1000);
+    for (auto& queue : waiting_) {
+        while (!queue.empty()) {
+            const RateLimiter::Class request_class = queue.front()->request_class;
+            if (!limiter_.try_acquire_waiter(request_class)) {
+                auto wait = std::chrono::ceil<std::chrono::milliseconds>(limiter_.wait_time(request_class));
+                next = std::min(next, std::max(wait, std::chrono::milliseconds(1)));
+                break;
+            }
+            std::unique_ptr<Request> request = std::move(queue.front());
+            queue.pop_front();
+            start(std::move(request));
+        }
+    }
+    return next;
+}
+
+void AsyncAPI::start(std::unique_ptr<Request> request) {
+    CURL* easy = nullptr;
+    if (!idle_handles_.empty()) {
+        easy = idle_handles_.back();
+        idle_handles_.pop_back();
+        curl_easy_reset(easy);
+    } else {
+        easy = curl_easy_init();
+    }
+    if (!easy) {
+        in_flight_.fetch_sub(1, std::memory_order_relaxed);
+        request->on_done({{"error", "CURL initialization failed"}});
+        return;
+    }
+
+    request->headers = curl_slist_append(nullptr, "Content-Type: application/json");
+    if (!request->auth_header.empty()) {
+        request->headers = curl_slist_append(request->headers, request->auth_header.c_str());
+    }
+
+    curl_easy_setopt(easy, CURLOPT_URL, request->url.c_str());
+    curl_easy_setopt(easy, CURLOPT_POST, 1L);
+    curl_easy_setopt(easy, CURLOPT_POSTFIELDS, request->body.c_str());
+    curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE, static_cast<long>(request->body.size()));
+    curl_easy_setopt(easy, CURLOPT_HTTPHEADER, request->headers);
+    curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, AsyncWriteCallback);
+    curl_easy_setopt(easy, CURLOPT_WRITEDATA, &request->response);
+    curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(easy, CURLOPT_TCP_NODELAY, 1L);
+    curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);
+    curl_easy_setopt(easy, CURLOPT_PRIVATE, request.get());
+
+    request->easy = easy;
+    curl_multi_add_handle(multi_, easy);
+    active_.push_back(std::move(request));
+}
+
+void AsyncAPI::complete(CURL* easy, CURLcode result) {
+    Request* raw = nullptr;
+    curl_easy_getinfo(easy, CURLINFO_PRIVATE, reinterpret_cast<char**>(&raw));
+    curl_multi_remove_handle(multi_, easy);
+
+    std::unique_ptr<Request> request;
+    for (size_t i = 0; i < active_.size(); ++i) {
+        if (active_[i].get() == raw) {
+            request = std::move(active_[i]);
+            active_[i] = std::move(active_.back());
+            active_.pop_back();
+            break;
+        }
+    }
+    curl_slist_free_all(raw->headers);
+    raw->headers = nullptr;
+    idle_handles_.push_back(easy);  // keeps its place in the multi connection cache
+
+    json response;
+    if (result == CURLE_OK && !request->response.empty()) {
+        response = json::parse(request->response, nullptr, false);
+    }
+    // ✅ The server's bucket ran dry before ours: resync and send it again once credits are back
+    if (!request->retried && RateLimiter::is_rate_limited(response)) {
+        limiter_.on_rejected(request->request_class.pool);
+        request->retried = true;
+        request->response.clear();
+        request->easy = nullptr;
+        limiter_.add_waiter(request->request_class);
+        waiting_[static_cast<int>(request->request_class.priority)].push_front(std::move(request));
+        return;
+    }
+
+    if (result != CURLE_OK) {
+        response = {{"error", curl_easy_strerror(result)}};
+    } else if (request->response.empty()) {
+        response = {{"error", "Empty response"}};
+    } else if (response.is_discarded()) {
+        try {
+            response = json::parse(request->response);
+        } catch (const json::parse_error& e) {
+            response = {{"error", "JSON Parse Error"}, {"details", e.what()}, {"raw_response", request->response}};
+        }
+    }
+
+    in_flight_.fetch_sub(1, std::memory_order_relaxed);
+    request->on_done(std::move(response));
+}
+
+void AsyncAPI::run() {
+    while (running_) {
+        int still_running = 0;
+        curl_multi_perform(multi_, &still_running);
+
+        int queued_messages = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi_, &queued_messages)) {
+            if (msg->msg == CURLMSG_DONE) {
+                complete(msg->easy_handle, msg->data.result);
+            }
+        }
+
+        // After completions, so a rate-limited retry is timed in this pass
+        std::chrono::milliseconds timeout = start_queued();
+
+        // Sleeps until a socket is ready, a timeout fires, credits refill for
+        // a waiting request or submit() wakes us
+        curl_multi_poll(multi_, nullptr, 0, static_cast<int>(timeout.count()), nullptr);
+    }
+}
+
+void AsyncAPI::fail_all(const std::string& reason) {
+    for (auto& request : active_) {
+        curl_multi_remove_handle(multi_, request->easy);
+        curl_easy_cleanup(request->easy);
+        curl_slist_free_all(request->headers);
+        request->on_done({{"error", reason}});
+    }
+    active_.clear();
+
+    for (auto& queue : waiting_) {
+        for (auto& request : queue) {
+            limiter_.remove_waiter(request->request_class);
+            request->on_done({{"error", reason}});
+        }
+        queue.clear();
+    }
+
+    std::vector<std::unique_ptr<Request>> batch;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        batch.swap(queued_);
+    }
+    for (auto& request : batch) {
+        request->on_done({{"error", reason}});
+    }
+    in_flight_ = 0;
+}
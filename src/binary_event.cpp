@@ -0,0 +1,117 @@
+#include "../include/binary_event.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+template <size_t N>
+void copy_text(char (&field)[N], std::string_view text) {
+    // Truncated when longer; the buffer is already zeroed
+    std::memcpy(field, text.data(), text.size() < N ? text.size() : N);
+}
+
+OrderRecord::State order_state(std::string_view state) {
+    if (state == "open") return OrderRecord::State::Open;
+    if (state == "filled") return OrderRecord::State::Filled;
+    if (state == "rejected") return OrderRecord::State::Rejected;
+    if (state == "cancelled") return OrderRecord::State::Cancelled;
+    if (state == "untriggered") return OrderRecord::State::Untriggered;
+    return OrderRecord::State::Unknown;
+}
+
+void put_levels(BookLevelRecord* out, const std::vector<BookLevelUpdate>& levels) {
+    for (const BookLevelUpdate& level : levels) {
+        out->price_mantissa = level.price.mantissa;
+        out->amount_mantissa = level.amount.mantissa;
+        out->price_scale = static_cast<int8_t>(level.price.scale);
+        out->amount_scale = static_cast<int8_t>(level.amount.scale);
+        out->action = level.action;
+        ++out;
+    }
+}
+
+}  // namespace
+
+EventBuffer::Line* EventBuffer::grow(size_t lines) {
+    if (lines_.size() < used_ + lines) {
+        lines_.resize(std::max(used_ + lines, lines_.size() * 2));
+    }
+    Line* at = &lines_[used_];
+    used_ += lines;
+    return at;
+}
+
+EventHeader* EventBuffer::append_raw(const void* record, size_t size) {
+    Line* at = grow(size / kEventAlign);
+    std::memcpy(static_cast<void*>(at), record, size);
+    return reinterpret_cast<EventHeader*>(at);
+}
+
+size_t encode_events(const Notification& notification, EventBuffer& out) {
+    InstrumentId instrument = notification.instrument;
+    int64_t received_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    auto stamp = [&](EventHeader& header, int64_t timestamp) {
+        header.instrument = instrument;
+        header.timestamp = timestamp;
+        header.received_ns = received_ns;
+    };
+
+    switch (notification.kind) {
+        case Notification::Kind::Book: {
+            const BookUpdate& book = notification.book;
+            size_t levels = book.bids.size() + book.asks.size();
+            BookRecord* record = out.append<BookRecord>(levels * sizeof(BookLevelRecord));
+            stamp(record->header, book.timestamp);
+            record->header.flags = book.snapshot ? BookRecord::kSnapshot : 0;
+            record->header.count = static_cast<uint32_t>(levels);
+            record->change_id = book.change_id;
+            record->prev_change_id = book.prev_change_id;
+            record->bid_count = static_cast<uint32_t>(book.bids.size());
+            put_levels(record->levels(), book.bids);
+            put_levels(record->levels() + book.bids.size(), book.asks);
+            return 1;
+        }
+        case Notification::Kind::Trades:
+            for (size_t i = 0; i < notification.trade_count; ++i) {
+                const TradeEvent& trade = notification.trades[i];
+                TradeRecord* record = out.append<TradeRecord>();
+                stamp(record->header, trade.timestamp);
+                record->header.flags = trade.buy ? TradeRecord::kBuy : 0;
+                record->trade_seq = trade.trade_seq;
+                record->price = trade.price;
+                record->amount = trade.amount;
+                copy_text(record->trade_id, trade.trade_id);
+            }
+            return notification.trade_count;
+        case Notification::Kind::Ticker: {
+            const TickerEvent& ticker = notification.ticker;
+            TickerRecord* record = out.append<TickerRecord>();
+            stamp(record->header, ticker.timestamp);
+            record->best_bid_price = ticker.best_bid_price;
+            record->best_bid_amount = ticker.best_bid_amount;
+            record->best_ask_price = ticker.best_ask_price;
+            record->best_ask_amount = ticker.best_ask_amount;
+            record->last_price = ticker.last_price;
+            record->mark_price = ticker.mark_price;
+            record->index_price = ticker.index_price;
+            return 1;
+        }
+        case Notification::Kind::UserOrders:
+            for (size_t i = 0; i < notification.order_count; ++i) {
+                const UserOrderEvent& order = notification.orders[i];
+                OrderRecord* record = out.append<OrderRecord>();
+                stamp(record->header, order.last_update_timestamp);
+                record->header.flags = order.buy ? OrderRecord::kBuy : 0;
+                record->price = order.price;
+                record->amount = order.amount;
+                record->filled_amount = order.filled_amount;
+                record->average_price = order.average_price;
+                record->state = order_state(order.order_state);
+                copy_text(record->order_id, order.order_id);
+            }
+            return notification.order_count;
+        default:
+            return 0;
+    }
+}
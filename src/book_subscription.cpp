@@ -0,0 +1,121 @@
+#include "../include/book_subscription.h"
+#include <charconv>
+
+const char* to_string(BookSubscription::Interval interval) {
+    switch (interval) {
+        case BookSubscription::Interval::Raw: return "raw";
+        case BookSubscription::Interval::Ms100: return "100ms";
+        case BookSubscription::Interval::Agg2: return "agg2";
+    }
+    return "100ms";
+}
+
+bool parse_interval(std::string_view text, BookSubscription::Interval& out) {
+    if (text == "raw") out = BookSubscription::Interval::Raw;
+    else if (text == "100ms") out = BookSubscription::Interval::Ms100;
+    else if (text == "agg2") out = BookSubscription::Interval::Agg2;
+    else return false;
+    return true;
+}
+
+BookSubscription BookSubscription::incremental(std::string instrument, Interval interval) {
+    BookSubscription spec;
+    spec.instrument = std::move(instrument);
+    spec.interval = interval;
+    return spec;
+}
+
+BookSubscription BookSubscription::grouped(std::string instrument, int depth, Interval interval, std::string group) {
+    BookSubscription spec;
+    spec.instrument = std::move(instrument);
+    spec.interval = interval;
+    spec.group = std::move(group);
+    spec.depth = depth;
+    return spec;
+}
+
+namespace {
+
+bool valid_spec(std::string_view instrument, BookSubscription::Interval interval, std::string_view group,
+                int depth) {
+    if (instrument.empty() || instrument.find('.') != std::string_view::npos) {
+        return false;
+    }
+    if (depth <= 0) {
+        return depth == 0 && group.empty();
+    }
+    if (interval == BookSubscription::Interval::Raw || (depth != 1 && depth != 10 && depth != 20)) {
+        return false;
+    }
+    if (group == "none") {
+        return true;
+    }
+    // Price buckets are positive integers
+    unsigned value = 0;
+    auto result = std::from_chars(group.data(), group.data() + group.size(), value);
+    return result.ec == std::errc() && result.ptr == group.data() + group.size() && value > 0;
+}
+
+}  // namespace
+
+bool BookSubscription::is_valid() const {
+    return valid_spec(instrument, interval, group, depth);
+}
+
+std::string BookSubscription::channel() const {
+    std::string channel = "book." + instrument + ".";
+    if (is_grouped()) {
+        channel += group;
+        channel += '.';
+        channel += std::to_string(depth);
+        channel += '.';
+    }
+    channel += to_string(interval);
+    return channel;
+}
+
+bool BookSubscription::parse(std::string_view channel, BookSubscription& out) {
+    static constexpr std::string_view kPrefix = "book.";
+    if (channel.substr(0, kPrefix.size()) != kPrefix) {
+        return false;
+    }
+    channel.remove_prefix(kPrefix.size());
+
+    // Split the rest on '.': instrument names never contain one
+    std::string_view parts[4];
+    size_t count = 0;
+    while (count < 4) {
+        size_t dot = channel.find('.');
+        parts[count++] = channel.substr(0, dot);
+        if (dot == std::string_view::npos) {
+            channel = {};
+            break;
+        }
+        channel.remove_prefix(dot + 1);
+    }
+    if (!channel.empty() || (count != 2 && count != 4)) {
+        return false;
+    }
+
+    Interval interval;
+    if (!parse_interval(parts[count - 1], interval)) {
+        return false;
+    }
+    std::string_view group;
+    int depth = 0;
+    if (count == 4) {
+        group = parts[1];
+        auto result = std::from_chars(parts[2].data(), parts[2].data() + parts[2].size(), depth);
+        if (result.ec != std::errc() || result.ptr != parts[2].data() + parts[2].size()) {
+            return false;
+        }
+    }
+    if (!valid_spec(parts[0], interval, group, depth)) {
+        return false;
+    }
+    out.instrument.assign(parts[0].data(), parts[0].size());
+    out.interval = interval;
+    out.group.assign(group.data(), group.size());
+    out.depth = depth;
+    return true;
+}
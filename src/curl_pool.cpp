@@ -0,0 +1,153 @@
+#include "../include/curl_pool.h"
+#include <iostream>
+
+CurlPool::Handle::Handle(CurlPool* pool, std::string host, CURL* curl)
+    : pool_(pool), host_(std::move(host)), curl_(curl) {}
+
+CurlPool::Handle::Handle(Handle&& other) noexcept
+    : pool_(other.pool_), host_(std::move(other.host_)), curl_(other.curl_) {
+    other.pool_ = nullptr;
+    other.curl_ = nullptr;
+}
+
+CurlPool::Handle& CurlPool::Handle::operator=(Handle&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool_ = other.pool_;
+        host_ = std::move(other.host_);
+        curl_ = other.curl_;
+        other.pool_ = nullptr;
+        other.curl_ = nullptr;
+    }
+    return *this;
+}
+
+CurlPool::Handle::~Handle() {
+    release();
+}
+
+void CurlPool::Handle::release() {
+    if (pool_ && curl_) {
+        pool_->release(host_, curl_);
+    }
+    pool_ = nullptr;
+    curl_ = nullptr;
+}
+
+CurlPool::CurlPool(size_t max_idle_per_host) : max_idle_per_host_(max_idle_per_host) {
+    share_ = curl_share_init();
+    if (share_) {
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &CurlPool::share_lock);
+        curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &CurlPool::share_unlock);
+        curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+    }
+}
+
+CurlPool::~CurlPool() {
+    for (auto& entry : idle_) {
+        for (CURL* curl : entry.second) {
+            curl_easy_cleanup(curl);
+        }
+    }
+    // Handles still leased out at this point would outlive the share; callers
+    // must not keep a Handle past the pool's lifetime.
+    if (share_) {
+        curl_share_cleanup(share_);
+    }
+}
+
+std::string CurlPool::host_of(const std::string& url) {
+    // scheme://host[:port]/path -> scheme://host[:port]
+    size_t scheme_end = url.find("://");
+    size_t host_start = (scheme_end == std::string::npos) ? 0 : scheme_end + 3;
+    size_t host_end = url.find('/', host_start);
+    return url.substr(0, host_end);
+}
+
+void CurlPool::share_lock(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+    static_cast<CurlPool*>(userptr)->share_mutexes_[data].lock();
+}
+
+void CurlPool::share_unlock(CURL*, curl_lock_data data, void* userptr) {
+    static_cast<CurlPool*>(userptr)->share_mutexes_[data].unlock();
+}
+
+void CurlPool::apply_defaults(CURL* curl) {
+    // ✅ Keep idle connections alive so the next order reuses them
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPIDLE, 30L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPINTVL, 15L);
+    curl_easy_setopt(curl, CURLOPT_TCP_NODELAY, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    if (share_) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, share_);
+    }
+}
+
+CURL* CurlPool::create_handle() {
+    CURL* curl = curl_easy_init();
+    if (curl) {
+        apply_defaults(curl);
+    }
+    return curl;
+}
+
+CurlPool::Handle CurlPool::acquire(const std::string& url) {
+    std::string host = host_of(url);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = idle_.find(host);
+        if (it != idle_.end() && !it->second.empty()) {
+            CURL* curl = it->second.back();
+            it->second.pop_back();
+            return Handle(this, std::move(host), curl);
+        }
+    }
+
+    CURL* curl = create_handle();
+    if (!curl) {
+        return Handle();
+    }
+    return Handle(this, std::move(host), curl);
+}
+
+void CurlPool::release(const std::string& host, CURL* curl) {
+    // curl_easy_reset clears the options of the last transfer but keeps the
+    // live connections, so the handle comes back warm.
+    curl_easy_reset(curl);
+    apply_defaults(curl);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& handles = idle_[host];
+    if (handles.size() < max_idle_per_host_) {
+        handles.push_back(curl);
+        return;
+    }
+    curl_easy_cleanup(curl);
+}
+
+static size_t DiscardCallback(void*, size_t size, size_t nmemb, void*) {
+    return size * nmemb;
+}
+
+void CurlPool::warm_up(const std::string& url, size_t count) {
+    std::vector<Handle> handles;
+    for (size_t i = 0; i < count; ++i) {
+        Handle handle = acquire(url);
+        if (!handle) {
+            std::cerr << "Failed to initialize cURL" << std::endl;
+            return;
+        }
+        curl_easy_setopt(handle.get(), CURLOPT_URL, url.c_str());
+        curl_easy_setopt(handle.get(), CURLOPT_WRITEFUNCTION, DiscardCallback);
+
+        CURLcode res = curl_easy_perform(handle.get());
+        if (res != CURLE_OK) {
+            std::cerr << "cURL warm-up failed: " << curl_easy_strerror(res) << std::endl;
+        }
+        // Hold on to the lease so the next iteration opens another connection
+        handles.push_back(std::move(handle));
+    }
+}
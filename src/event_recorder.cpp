@@ -0,0 +1,149 @@
+#include "../include/event_recorder.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+constexpr char kMagic[8] = {'D', 'R', 'B', 'E', 'V', 'T', '\0', '\0'};
+constexpr uint32_t kVersion = 1;
+
+struct alignas(kEventAlign) RecordingHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_align;
+};
+
+// Smallest size each record type can have
+size_t min_size(EventType type) {
+    switch (type) {
+        case EventType::Instrument: return sizeof(InstrumentRecord);
+        case EventType::Book: return sizeof(BookRecord);
+        case EventType::Trade: return sizeof(TradeRecord);
+        case EventType::Ticker: return sizeof(TickerRecord);
+        case EventType::Order: return sizeof(OrderRecord);
+    }
+    return 0;
+}
+
+}  // namespace
+
+EventRecorder::EventRecorder(const std::string& path) {
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        std::cerr << "❌ Cannot open recording " << path << std::endl;
+        return;
+    }
+    RecordingHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.record_align = kEventAlign;
+    write_bytes(&header, sizeof(header));
+}
+
+EventRecorder::~EventRecorder() {
+    if (file_) {
+        std::fclose(file_);
+    }
+}
+
+bool EventRecorder::write_bytes(const void* data, size_t size) {
+    if (ok_ && std::fwrite(data, 1, size, file_) != size) {
+        std::cerr << "❌ Recording write failed, further events are dropped" << std::endl;
+        ok_ = false;
+    }
+    return ok_;
+}
+
+void EventRecorder::name_instrument(InstrumentId id) {
+    if (id >= named_.size()) {
+        named_.resize(static_cast<size_t>(id) + 1);
+    }
+    named_[id] = true;
+    InstrumentRecord record{};
+    record.header.type = InstrumentRecord::kType;
+    record.header.size = sizeof(InstrumentRecord);
+    record.header.instrument = id;
+    const std::string& name = InstrumentRegistry::instance().name(id);
+    std::memcpy(record.name, name.data(), std::min(name.size(), sizeof(record.name) - 1));
+    write_bytes(&record, sizeof(record));
+}
+
+bool EventRecorder::write(const EventBuffer& events) {
+    if (!file_ || !ok_) {
+        return false;
+    }
+    // ✅ Runs of records whose instruments are already named go out in one fwrite
+    const char* base = static_cast<const char*>(events.data());
+    const char* run = base;
+    events.for_each([&](const EventHeader& header) {
+        InstrumentId id = header.instrument;
+        if (id != kNoInstrument && (id >= named_.size() || !named_[id])) {
+            const char* at = reinterpret_cast<const char*>(&header);
+            write_bytes(run, static_cast<size_t>(at - run));
+            run = at;
+            name_instrument(id);
+        }
+    });
+    write_bytes(run, static_cast<size_t>(base + events.size() - run));
+    return ok_;
+}
+
+void EventRecorder::flush() {
+    if (file_) {
+        std::fflush(file_);
+    }
+}
+
+bool load_recording(const std::string& path, EventBuffer& out) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    RecordingHeader header{};
+    bool ok = std::fread(&header, sizeof(header), 1, file) == 1 &&
+              std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+              header.version == kVersion && header.record_align == kEventAlign;
+
+    std::vector<InstrumentId> ids;  // file id -> id in this process
+    RecordingHeader line;           // aligned scratch for one header line
+    std::vector<char> record;
+    while (ok) {
+        if (std::fread(&line, sizeof(line), 1, file) != 1) {
+            ok = std::feof(file) != 0;  // clean end between records
+            break;
+        }
+        EventHeader event;
+        std::memcpy(&event, &line, sizeof(event));
+        size_t need = min_size(event.type);
+        if (event.type == EventType::Book) {
+            need += static_cast<size_t>(event.count) * sizeof(BookLevelRecord);
+        }
+        if (need == 0 || event.size % kEventAlign != 0 || event.size < need) {
+            ok = false;
+            break;
+        }
+        record.resize(event.size);
+        std::memcpy(record.data(), &line, sizeof(line));
+        if (event.size > sizeof(line) &&
+            std::fread(record.data() + sizeof(line), event.size - sizeof(line), 1, file) != 1) {
+            ok = false;
+            break;
+        }
+
+        EventHeader* copy = out.append_raw(record.data(), record.size());
+        InstrumentId file_id = copy->instrument;
+        if (copy->type == EventType::Instrument) {
+            if (file_id == kNoInstrument) {
+                continue;
+            }
+            if (file_id >= ids.size()) {
+                ids.resize(static_cast<size_t>(file_id) + 1, kNoInstrument);
+            }
+            const auto& named = event_cast<InstrumentRecord>(*copy);
+            ids[file_id] = InstrumentRegistry::instance().intern(event_text(named.name));
+        }
+        copy->instrument = file_id < ids.size() ? ids[file_id] : kNoInstrument;
+    }
+    std::fclose(file);
+    return ok;
+}
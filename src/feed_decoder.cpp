@@ -0,0 +1,516 @@
+#include "../include/feed_decoder.h"
+#include <charconv>
+
+namespace {
+
+bool starts_with(std::string_view s, std::string_view prefix) {
+    return s.substr(0, prefix.size()) == prefix;
+}
+
+enum class Field {
+    None, Method, Params, Channel, Data, Type, Timestamp, Instrument, ChangeId, PrevChangeId,
+    Bids, Asks, TradeId, TradeSeq, Price, Amount, Direction, BestBidPrice, BestBidAmount,
+    BestAskPrice, BestAskAmount, LastPrice, MarkPrice, IndexPrice, OrderId, OrderState,
+    FilledAmount, AveragePrice, LastUpdateTimestamp
+};
+
+Field field_of(std::string_view key) {
+    // Only the keys we decode; everything else is skipped
+    switch (key.size()) {
+        case 4:
+            if (key == "data") return Field::Data;
+            if (key == "type") return Field::Type;
+            if (key == "bids") return Field::Bids;
+            if (key == "asks") return Field::Asks;
+            break;
+        case 5:
+            if (key == "price") return Field::Price;
+            break;
+        case 6:
+            if (key == "method") return Field::Method;
+            if (key == "params") return Field::Params;
+            if (key == "amount") return Field::Amount;
+            break;
+        case 7:
+            if (key == "channel") return Field::Channel;
+            break;
+        case 8:
+            if (key == "trade_id") return Field::TradeId;
+            if (key == "order_id") return Field::OrderId;
+            break;
+        case 9:
+            if (key == "timestamp") return Field::Timestamp;
+            if (key == "change_id") return Field::ChangeId;
+            if (key == "trade_seq") return Field::TradeSeq;
+            if (key == "direction") return Field::Direction;
+            break;
+        case 10:
+            if (key == "last_price") return Field::LastPrice;
+            if (key == "mark_price") return Field::MarkPrice;
+            break;
+        case 11:
+            if (key == "index_price") return Field::IndexPrice;
+            if (key == "order_state") return Field::OrderState;
+            break;
+        case 13:
+            if (key == "average_price") return Field::AveragePrice;
+            if (key == "filled_amount") return Field::FilledAmount;
+            break;
+        case 14:
+            if (key == "prev_change_id") return Field::PrevChangeId;
+            if (key == "best_bid_price") return Field::BestBidPrice;
+            if (key == "best_ask_price") return Field::BestAskPrice;
+            break;
+        case 15:
+            if (key == "instrument_name") return Field::Instrument;
+            if (key == "best_bid_amount") return Field::BestBidAmount;
+            if (key == "best_ask_amount") return Field::BestAskAmount;
+            break;
+        case 21:
+            if (key == "last_update_timestamp") return Field::LastUpdateTimestamp;
+            break;
+        default:
+            break;
+    }
+    return Field::None;
+}
+
+// Reset in place so the strings keep their capacity
+void reset(TradeEvent& trade) {
+    trade.instrument.clear();
+    trade.trade_id.clear();
+    trade.trade_seq = 0;
+    trade.timestamp = 0;
+    trade.price = 0.0;
+    trade.amount = 0.0;
+    trade.buy = false;
+}
+
+void reset(UserOrderEvent& order) {
+    order.order_id.clear();
+    order.instrument.clear();
+    order.order_state.clear();
+    order.buy = false;
+    order.price = 0.0;
+    order.amount = 0.0;
+    order.filled_amount = 0.0;
+    order.average_price = 0.0;
+    order.last_update_timestamp = 0;
+}
+
+void reset(TickerEvent& ticker) {
+    ticker.instrument.clear();
+    ticker.timestamp = 0;
+    ticker.best_bid_price = 0.0;
+    ticker.best_bid_amount = 0.0;
+    ticker.best_ask_price = 0.0;
+    ticker.best_ask_amount = 0.0;
+    ticker.last_price = 0.0;
+    ticker.mark_price = 0.0;
+    ticker.index_price = 0.0;
+}
+
+// SAX handler for JsonScanner that writes straight into a Notification
+class NotificationSax {
+public:
+    // 'book' receives the parsed book channel
+    NotificationSax(Notification& out, BookSubscription& book) : out_(out), book_(book) {}
+
+    bool is_notification() const { return is_subscription_; }
+    bool has_book_type() const { return has_book_type_; }
+    // The payload was decoded, not skipped
+    bool has_data() const { return has_data_; }
+    // "data" was reached before "channel", so it was skipped
+    bool data_deferred() const { return data_deferred_; }
+
+    // Ready for another pass over the same frame; the kind found by the
+    // first pass stays in the Notification
+    void restart();
+
+    bool null() { field_ = Field::None; return true; }
+    bool boolean(bool) { field_ = Field::None; return true; }
+    bool number(std::string_view literal, bool is_integer);
+
+    bool string(std::string_view value);
+    bool key(std::string_view key);
+    bool start_object();
+    bool end_object() { return pop(); }
+    bool start_array();
+    bool end_array() { return pop(); }
+
+private:
+    enum class Ctx : uint8_t { Root, Params, Data, DataArray, Item, Levels, Level, Ignore };
+
+    // 'text' is the literal for floats, empty for integers
+    bool number(double value, int64_t integer, std::string_view text);
+    bool push(Ctx ctx);
+    TradeEvent* next_trade();
+    UserOrderEvent* next_order();
+    bool pop();
+    Ctx top() const { return depth_ == 0 ? Ctx::Ignore : stack_[depth_ - 1]; }
+
+    Notification& out_;
+    BookSubscription& book_;
+    Field field_ = Field::None;
+    bool is_subscription_ = false;
+    bool has_book_type_ = false;
+    bool has_data_ = false;
+    bool data_deferred_ = false;
+
+    static constexpr int kMaxDepth = 8;
+    Ctx stack_[kMaxDepth];
+    int depth_ = 0;
+    int ignore_depth_ = 0;  // nesting below an Ignore context
+
+    std::vector<BookLevelUpdate>* levels_ = nullptr;  // side being filled
+    BookLevelUpdate* level_ = nullptr;
+    int level_numbers_ = 0;
+    TradeEvent* trade_ = nullptr;
+    UserOrderEvent* order_ = nullptr;
+};
+
+TradeEvent* NotificationSax::next_trade() {
+    if (out_.trade_count == out_.trades.size()) out_.trades.emplace_back();
+    TradeEvent* trade = &out_.trades[out_.trade_count++];
+    reset(*trade);
+    return trade;
+}
+
+UserOrderEvent* NotificationSax::next_order() {
+    if (out_.order_count == out_.orders.size()) out_.orders.emplace_back();
+    UserOrderEvent* order = &out_.orders[out_.order_count++];
+    reset(*order);
+    return order;
+}
+
+void NotificationSax::restart() {
+    field_ = Field::None;
+    is_subscription_ = false;
+    has_book_type_ = false;
+    has_data_ = false;
+    data_deferred_ = false;
+    depth_ = 0;
+    ignore_depth_ = 0;
+    levels_ = nullptr;
+    level_ = nullptr;
+    trade_ = nullptr;
+    order_ = nullptr;
+}
+
+bool NotificationSax::push(Ctx ctx) {
+    if (ignore_depth_ > 0 || depth_ == kMaxDepth) {
+        ++ignore_depth_;
+        return true;
+    }
+    stack_[depth_++] = ctx;
+    field_ = Field::None;
+    return true;
+}
+
+bool NotificationSax::pop() {
+    if (ignore_depth_ > 0) {
+        --ignore_depth_;
+        return true;
+    }
+    if (depth_ > 0) {
+        --depth_;
+    }
+    field_ = Field::None;
+    return true;
+}
+
+bool NotificationSax::start_object() {
+    if (ignore_depth_ > 0) {
+        return push(Ctx::Ignore);
+    }
+    if (depth_ == 0) {
+        return push(Ctx::Root);
+    }
+
+    Ctx ctx = top();
+    Field field = field_;
+    if (ctx == Ctx::Root && field == Field::Params) {
+        return push(Ctx::Params);
+    }
+    if (ctx == Ctx::Params && field == Field::Data) {
+        switch (out_.kind) {
+            case Notification::Kind::Book:
+            case Notification::Kind::Ticker:
+                has_data_ = true;
+                return push(Ctx::Data);
+            case Notification::Kind::UserOrders:
+                // user.orders.*.raw sends one order object, not an array
+                has_data_ = true;
+                order_ = next_order();
+                return push(Ctx::Item);
+            case Notification::Kind::None:
+                // No channel yet, so no way to tell what the payload is
+                data_deferred_ = true;
+                break;
+            default:
+                break;
+        }
+    }
+    if (ctx == Ctx::DataArray) {
+        if (out_.kind == Notification::Kind::Trades) {
+            trade_ = next_trade();
+            return push(Ctx::Item);
+        }
+        if (out_.kind == Notification::Kind::UserOrders) {
+            order_ = next_order();
+            return push(Ctx::Item);
+        }
+    }
+    return push(Ctx::Ignore);
+}
+
+bool NotificationSax::start_array() {
+    if (ignore_depth_ > 0 || depth_ == 0) {
+        return push(Ctx::Ignore);
+    }
+
+    Ctx ctx = top();
+    Field field = field_;
+    if (ctx == Ctx::Params && field == Field::Data) {
+        if (out_.kind == Notification::Kind::Trades || out_.kind == Notification::Kind::UserOrders) {
+            has_data_ = true;
+            return push(Ctx::DataArray);
+        }
+        if (out_.kind == Notification::Kind::None) {
+            data_deferred_ = true;
+        }
+    }
+    if (ctx == Ctx::Data && out_.kind == Notification::Kind::Book && (field == Field::Bids || field == Field::Asks)) {
+        levels_ = field == Field::Bids ? &out_.book.bids : &out_.book.asks;
+        return push(Ctx::Levels);
+    }
+    if (ctx == Ctx::Levels) {
+        levels_->push_back({BookLevelUpdate::Action::New, Decimal{}, Decimal{}});
+        level_ = &levels_->back();
+        level_numbers_ = 0;
+        return push(Ctx::Level);
+    }
+    return push(Ctx::Ignore);
+}
+
+bool NotificationSax::key(std::string_view key) {
+    field_ = (ignore_depth_ > 0) ? Field::None : field_of(key);
+    return true;
+}
+
+bool NotificationSax::string(std::string_view value) {
+    if (ignore_depth_ > 0 || depth_ == 0) {
+        return true;
+    }
+
+    Field field = field_;
+    field_ = Field::None;
+    switch (top()) {
+        case Ctx::Root:
+            if (field == Field::Method) {
+                is_subscription_ = (value == "subscription");
+                // Responses and heartbeats are not ours to decode
+                return is_subscription_;
+            }
+            break;
+        case Ctx::Params:
+            if (field == Field::Channel) {
+                out_.channel.assign(value);
+                if (FeedDecoder::carries_instrument(value)) {
+                    // One perfect-hash lookup instead of hashing names downstream
+                    std::string_view instrument = InstrumentRegistry::instrument_of(value);
+                    if (!instrument.empty()) {
+                        out_.instrument = InstrumentRegistry::instance().find(instrument);
+                    }
+                }
+                if (starts_with(value, "book.")) {
+                    // The channel format says whether messages are typed
+                    // snapshots and changes or whole grouped books
+                    out_.kind = BookSubscription::parse(value, book_) ? Notification::Kind::Book
+                                                                      : Notification::Kind::Other;
+                } else if (starts_with(value, "trades.")) {
+                    out_.kind = Notification::Kind::Trades;
+                } else if (starts_with(value, "ticker.")) {
+                    out_.kind = Notification::Kind::Ticker;
+                } else if (starts_with(value, "user.orders.")) {
+                    out_.kind = Notification::Kind::UserOrders;
+                } else {
+                    out_.kind = Notification::Kind::Other;
+                }
+            }
+            break;
+        case Ctx::Data:
+            if (field == Field::Instrument) {
+                (out_.kind == Notification::Kind::Book ? out_.book.instrument : out_.ticker.instrument).assign(value);
+            } else if (field == Field::Type) {
+                has_book_type_ = true;
+                out_.book.snapshot = (value == "snapshot");
+            }
+            break;
+        case Ctx::Item:
+            if (out_.kind == Notification::Kind::Trades) {
+                if (field == Field::Instrument) trade_->instrument.assign(value);
+                else if (field == Field::TradeId) trade_->trade_id.assign(value);
+                else if (field == Field::Direction) trade_->buy = (value == "buy");
+            } else {
+                if (field == Field::Instrument) order_->instrument.assign(value);
+                else if (field == Field::OrderId) order_->order_id.assign(value);
+                else if (field == Field::OrderState) order_->order_state.assign(value);
+                else if (field == Field::Direction) order_->buy = (value == "buy");
+            }
+            break;
+        case Ctx::Level:
+            if (value == "delete") level_->action = BookLevelUpdate::Action::Delete;
+            else if (value == "change") level_->action = BookLevelUpdate::Action::Change;
+            else level_->action = BookLevelUpdate::Action::New;
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+bool NotificationSax::number(std::string_view literal, bool is_integer) {
+    const char* first = literal.data();
+    const char* last = first + literal.size();
+    if (is_integer) {
+        int64_t integer = 0;
+        if (std::from_chars(first, last, integer).ec == std::errc()) {
+            return number(static_cast<double>(integer), integer, {});
+        }
+        // Past int64: only usable as a double
+    }
+    double value = 0.0;
+    if (std::from_chars(first, last, value).ec != std::errc()) {
+        return false;
+    }
+    return number(value, static_cast<int64_t>(value), literal);
+}
+
+bool NotificationSax::number(double value, int64_t integer, std::string_view text) {
+    if (ignore_depth_ > 0 || depth_ == 0) {
+        return true;
+    }
+
+    Field field = field_;
+    field_ = Field::None;
+    switch (top()) {
+        case Ctx::Data:
+            if (out_.kind == Notification::Kind::Book) {
+                BookUpdate& book = out_.book;
+                if (field == Field::Timestamp) book.timestamp = integer;
+                else if (field == Field::ChangeId) book.change_id = integer;
+                else if (field == Field::PrevChangeId) book.prev_change_id = integer;
+            } else {
+                TickerEvent& ticker = out_.ticker;
+                switch (field) {
+                    case Field::Timestamp: ticker.timestamp = integer; break;
+                    case Field::BestBidPrice: ticker.best_bid_price = value; break;
+                    case Field::BestBidAmount: ticker.best_bid_amount = value; break;
+                    case Field::BestAskPrice: ticker.best_ask_price = value; break;
+                    case Field::BestAskAmount: ticker.best_ask_amount = value; break;
+                    case Field::LastPrice: ticker.last_price = value; break;
+                    case Field::MarkPrice: ticker.mark_price = value; break;
+                    case Field::IndexPrice: ticker.index_price = value; break;
+                    default: break;
+                }
+            }
+            break;
+        case Ctx::Item:
+            if (out_.kind == Notification::Kind::Trades) {
+                switch (field) {
+                    case Field::TradeSeq: trade_->trade_seq = integer; break;
+                    case Field::Timestamp: trade_->timestamp = integer; break;
+                    case Field::Price: trade_->price = value; break;
+                    case Field::Amount: trade_->amount = value; break;
+                    default: break;
+                }
+            } else {
+                switch (field) {
+                    case Field::Price: order_->price = value; break;
+                    case Field::Amount: order_->amount = value; break;
+                    case Field::FilledAmount: order_->filled_amount = value; break;
+                    case Field::AveragePrice: order_->average_price = value; break;
+                    case Field::LastUpdateTimestamp: order_->last_update_timestamp = integer; break;
+                    default: break;
+                }
+            }
+            break;
+        case Ctx::Level:
+        {
+            // [action, price, amount] on raw/100ms books, [price, amount] on grouped ones
+            Decimal decimal{integer, 0};
+            if (!text.empty() && !parse_decimal(text, decimal)) {
+                return false;
+            }
+            if (level_numbers_ == 0) level_->price = decimal;
+            else if (level_numbers_ == 1) level_->amount = decimal;
+            ++level_numbers_;
+        }
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+}  // namespace
+
+bool FeedDecoder::carries_instrument(std::string_view channel) {
+    return starts_with(channel, "book.") || starts_with(channel, "trades.") ||
+           starts_with(channel, "ticker.") || starts_with(channel, "user.orders.");
+}
+
+bool FeedDecoder::decode(std::string_view frame, Notification& out) {
+    out.kind = Notification::Kind::None;
+    out.channel.clear();
+    out.instrument = kNoInstrument;
+    out.raw = frame;
+    out.book.instrument.clear();
+    out.book.snapshot = false;
+    out.book.timestamp = 0;
+    out.book.change_id = 0;
+    out.book.prev_change_id = -1;
+    out.book.bids.clear();
+    out.book.asks.clear();
+    reset(out.ticker);
+    out.trade_count = 0;
+    out.order_count = 0;
+
+    NotificationSax sax(out, book_);
+    bool ok = scanner_.parse(frame, sax);
+    if (ok && sax.is_notification() && sax.data_deferred() && out.kind != Notification::Kind::None &&
+        out.kind != Notification::Kind::Other) {
+        // "data" came before "channel": Deribit does not do this, but JSON
+        // key order is not guaranteed, so read the frame again now that the
+        // kind is known. The first pass filled nothing but channel and kind.
+        sax.restart();
+        ok = scanner_.parse(frame, sax);
+    }
+    if (!ok || !sax.is_notification() || out.kind == Notification::Kind::None) {
+        out.kind = Notification::Kind::None;
+        return false;
+    }
+    if (out.kind == Notification::Kind::Other) {
+        return true;
+    }
+    // A typed channel without its payload would reach the handlers as an
+    // empty update (an empty book snapshot clears the book)
+    bool complete = sax.has_data();
+    if (out.kind == Notification::Kind::Book) {
+        if (book_.is_grouped()) {
+            // book.<instrument>.<group>.<depth>.<interval> carries no type:
+            // every message is the whole depth-limited book
+            out.book.snapshot = true;
+        } else {
+            // Incremental channels type every message; guessing would either
+            // wipe the book or apply a snapshot as a change
+            complete = complete && sax.has_book_type();
+        }
+    }
+    if (!complete) {
+        out.kind = Notification::Kind::None;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,214 @@
+#include "../include/fixed_point.h"
+#include <cmath>
+
+static constexpr int64_t kPow10[] = {
+    1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL,
+    1000000000LL, 10000000000LL, 100000000000LL, 1000000000000LL, 10000000000000LL,
+    100000000000000LL, 1000000000000000LL, 10000000000000000LL, 100000000000000000LL,
+    1000000000000000000LL
+};
+static constexpr int kMaxPow10 = 18;
+
+bool parse_decimal(std::string_view text, Decimal& out) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    if (p == end) return false;
+
+    bool negative = false;
+    if (*p == '-' || *p == '+') {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;      // significant digits accumulated
+    int fraction = 0;    // digits taken after the point
+    int dropped = 0;     // integer digits past 18 that had to be zeros
+    bool any_digit = false;
+
+    for (; p != end && static_cast<unsigned>(*p - '0') <= 9; ++p) {
+        any_digit = true;
+        if (digits == kMaxPow10) {
+            if (*p != '0') return false;
+            ++dropped;
+            continue;
+        }
+        mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+        digits += (mantissa != 0);
+    }
+    if (p != end && *p == '.') {
+        ++p;
+        for (; p != end && static_cast<unsigned>(*p - '0') <= 9; ++p) {
+            any_digit = true;
+            if (digits == kMaxPow10) {
+                // Precision past 18 digits: only trailing zeros are acceptable
+                if (*p != '0') return false;
+                continue;
+            }
+            mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+            digits += (mantissa != 0);
+            ++fraction;
+        }
+    }
+    if (!any_digit) return false;
+
+    int exponent = 0;
+    if (p != end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool exp_negative = false;
+        if (p != end && (*p == '-' || *p == '+')) {
+            exp_negative = (*p == '-');
+            ++p;
+        }
+        if (p == end) return false;
+        for (; p != end && static_cast<unsigned>(*p - '0') <= 9; ++p) {
+            exponent = exponent * 10 + (*p - '0');
+            if (exponent > 100) return false;
+        }
+        if (exp_negative) exponent = -exponent;
+    }
+    if (p != end) return false;
+
+    int scale = fraction - exponent - dropped;
+    while (scale > 0 && mantissa != 0 && mantissa % 10 == 0) {
+        mantissa /= 10;
+        --scale;
+    }
+    if (mantissa == 0) {
+        scale = 0;
+    }
+    while (scale < 0) {
+        if (mantissa > static_cast<uint64_t>(kPow10[kMaxPow10]) / 10) return false;
+        mantissa *= 10;
+        ++scale;
+    }
+    if (scale > kMaxPow10 || mantissa > static_cast<uint64_t>(INT64_MAX)) return false;
+
+    out.mantissa = negative ? -static_cast<int64_t>(mantissa) : static_cast<int64_t>(mantissa);
+    out.scale = scale;
+    return true;
+}
+
+double to_double(Decimal value) {
+    if (value.scale >= 0 && value.scale <= kMaxPow10) {
+        return static_cast<double>(value.mantissa) / static_cast<double>(kPow10[value.scale]);
+    }
+    return static_cast<double>(value.mantissa) * std::pow(10.0, -value.scale);
+}
+
+size_t format_decimal(Decimal value, char* out) {
+    int64_t mantissa = value.mantissa;
+    int scale = value.scale;
+    while (scale > 0 && mantissa % 10 == 0) {
+        mantissa /= 10;
+        --scale;
+    }
+
+    char* p = out;
+    uint64_t magnitude = mantissa < 0 ? 0 - static_cast<uint64_t>(mantissa) : static_cast<uint64_t>(mantissa);
+    if (mantissa < 0) {
+        *p++ = '-';
+    }
+
+    char digits[24];
+    int count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    for (; scale < 0; ++scale) {
+        // Only reachable for hand-built Decimals; parse_decimal never yields it
+        *p++ = '0';
+    }
+
+    // digits[] is little-endian: [0, scale) is the fraction
+    if (count <= scale) {
+        *p++ = '0';
+        *p++ = '.';
+        for (int i = scale; i > count; --i) *p++ = '0';
+        for (int i = count - 1; i >= 0; --i) *p++ = digits[i];
+    } else {
+        for (int i = count - 1; i >= scale; --i) *p++ = digits[i];
+        if (scale > 0) {
+            *p++ = '.';
+            for (int i = scale - 1; i >= 0; --i) *p++ = digits[i];
+        }
+    }
+    return static_cast<size_t>(p - out);
+}
+
+FixedScale::FixedScale(Decimal unit) : unit_(unit) {}
+
+bool FixedScale::parse(std::string_view unit_text, FixedScale& out) {
+    Decimal unit;
+    if (!parse_decimal(unit_text, unit) || unit.mantissa <= 0) {
+        return false;
+    }
+    out = FixedScale(unit);
+    return true;
+}
+
+FixedScale FixedScale::from_double(double unit) {
+    // Tick sizes come from JSON as doubles; their shortest decimal form is
+    // the exact grid Deribit means (0.5, 0.0005, 2.5, ...)
+    for (int scale = 0; scale <= 12; ++scale) {
+        double scaled = unit * static_cast<double>(kPow10[scale]);
+        double rounded = std::round(scaled);
+        if (std::fabs(scaled - rounded) < 1e-9 * std::fmax(1.0, rounded)) {
+            return FixedScale(Decimal{static_cast<int64_t>(rounded), scale});
+        }
+    }
+    return FixedScale(Decimal{static_cast<int64_t>(std::llround(unit * 1e12)), 12});
+}
+
+// value / unit as an integer fraction num / den over a common power of ten
+static void ratio(Decimal value, Decimal unit, __int128& num, __int128& den) {
+    int common = value.scale > unit.scale ? value.scale : unit.scale;
+    num = static_cast<__int128>(value.mantissa) * kPow10[common - value.scale];
+    den = static_cast<__int128>(unit.mantissa) * kPow10[common - unit.scale];
+}
+
+bool FixedScale::to_units(Decimal value, int64_t& units) const {
+    __int128 num, den;
+    ratio(value, unit_, num, den);
+    if (num % den != 0) {
+        return false;
+    }
+    units = static_cast<int64_t>(num / den);
+    return true;
+}
+
+int64_t FixedScale::to_units_nearest(Decimal value) const {
+    __int128 num, den;
+    ratio(value, unit_, num, den);
+    __int128 quotient = num / den;
+    __int128 remainder = num % den;
+    if (2 * (remainder < 0 ? -remainder : remainder) >= den) {
+        quotient += (num < 0) ? -1 : 1;
+    }
+    return static_cast<int64_t>(quotient);
+}
+
+int64_t FixedScale::to_units_nearest(double value) const {
+    return std::llround(value * static_cast<double>(kPow10[unit_.scale]) / static_cast<double>(unit_.mantissa));
+}
+
+// 'value' in grid units, with a grid point returned exactly when 'value'
+// is one up to double rounding
+static double units_of(double value, Decimal unit) {
+    double units = value * static_cast<double>(kPow10[unit.scale]) / static_cast<double>(unit.mantissa);
+    double nearest = std::round(units);
+    return std::fabs(units - nearest) <= 1e-9 * std::fmax(1.0, std::fabs(nearest)) ? nearest : units;
+}
+
+int64_t FixedScale::to_units_floor(double value) const {
+    return static_cast<int64_t>(std::floor(units_of(value, unit_)));
+}
+
+int64_t FixedScale::to_units_ceil(double value) const {
+    return static_cast<int64_t>(std::ceil(units_of(value, unit_)));
+}
+
+double FixedScale::to_double(int64_t units) const {
+    return static_cast<double>(units * unit_.mantissa) / static_cast<double>(kPow10[unit_.scale]);
+}
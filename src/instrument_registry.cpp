@@ -0,0 +1,211 @@
+#include "../include/instrument_registry.h"
+#include <algorithm>
+#include <cstring>
+
+static uint64_t mix_word(uint64_t hash, uint64_t word) {
+    hash = (hash ^ word) * 0xFF51AFD7ED558CCDULL;
+    return hash ^ (hash >> 32);
+}
+
+// Eight bytes per multiply; the last word overlaps the one before it, so
+// there is no byte loop (and no variable-length memcpy) for the tail
+static uint64_t hash_name(std::string_view name) {
+    const char* p = name.data();
+    size_t n = name.size();
+    uint64_t hash = 0x9E3779B97F4A7C15ULL ^ n;
+    uint64_t word = 0;
+    if (n >= 8) {
+        const char* last = p + n - 8;
+        for (; p < last; p += 8) {
+            std::memcpy(&word, p, 8);
+            hash = mix_word(hash, word);
+        }
+        std::memcpy(&word, last, 8);
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            word |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+        }
+    }
+    return mix_word(hash, word);
+}
+
+InstrumentRegistry::InstrumentRegistry() {
+    current_ = build({});
+    table_.store(current_.get(), std::memory_order_release);
+}
+
+InstrumentRegistry::~InstrumentRegistry() = default;
+
+InstrumentRegistry& InstrumentRegistry::instance() {
+    static InstrumentRegistry registry;
+    return registry;
+}
+
+uint64_t InstrumentRegistry::slot_of(uint64_t hash, uint32_t seed, uint64_t mask) {
+    // The seed perturbs the hash, then a 64-bit finalizer spreads it
+    uint64_t h = hash ^ (static_cast<uint64_t>(seed) * 0x9E3779B97F4A7C15ULL);
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return h & mask;
+}
+
+std::unique_ptr<InstrumentRegistry::Table> InstrumentRegistry::build(std::vector<const std::string*> names) {
+    constexpr uint32_t kMaxSeed = 1u << 16;
+
+    auto table = std::make_unique<Table>();
+    table->names = std::move(names);
+    size_t n = table->names.size();
+    std::vector<uint64_t> hashes(n);
+    for (size_t id = 0; id < n; ++id) {
+        hashes[id] = hash_name(*table->names[id]);
+    }
+
+    // About two names per bucket, slots at most half full
+    size_t bucket_count = 1;
+    while (bucket_count * 2 < n) bucket_count *= 2;
+    size_t slot_count = 1;
+    while (slot_count < 2 * n) slot_count *= 2;
+    table->bucket_mask = bucket_count - 1;
+
+    std::vector<std::vector<InstrumentId>> buckets(bucket_count);
+    for (size_t id = 0; id < n; ++id) {
+        buckets[(hashes[id] >> 32) & table->bucket_mask].push_back(static_cast<InstrumentId>(id));
+    }
+    // Crowded buckets first, while most slots are still free
+    std::vector<size_t> order(bucket_count);
+    for (size_t b = 0; b < bucket_count; ++b) order[b] = b;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    std::vector<uint64_t> placed;
+    for (;;) {
+        table->slot_mask = slot_count - 1;
+        table->seeds.assign(bucket_count, 0);
+        table->slots.assign(slot_count, kNoInstrument);
+
+        bool complete = true;
+        for (size_t b : order) {
+            const std::vector<InstrumentId>& members = buckets[b];
+            if (members.empty()) {
+                break;
+            }
+            uint32_t seed = 0;
+            for (; seed < kMaxSeed; ++seed) {
+                placed.clear();
+                for (InstrumentId id : members) {
+                    uint64_t slot = slot_of(hashes[id], seed, table->slot_mask);
+                    if (table->slots[slot] != kNoInstrument ||
+                        std::find(placed.begin(), placed.end(), slot) != placed.end()) {
+                        break;
+                    }
+                    placed.push_back(slot);
+                }
+                if (placed.size() == members.size()) {
+                    break;
+                }
+            }
+            if (seed == kMaxSeed) {
+                complete = false;
+                break;
+            }
+            table->seeds[b] = seed;
+            for (size_t k = 0; k < members.size(); ++k) {
+                table->slots[placed[k]] = members[k];
+            }
+        }
+        if (complete) {
+            return table;
+        }
+        slot_count *= 2;  // too crowded for any seed: retry with more room
+    }
+}
+
+InstrumentId InstrumentRegistry::add_locked(std::string_view name) {
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    InstrumentId id = static_cast<InstrumentId>(storage_.size());
+    storage_.emplace_back(name);
+    ids_.emplace(storage_.back(), id);
+    return id;
+}
+
+void InstrumentRegistry::publish_locked() {
+    std::vector<const std::string*> names;
+    names.reserve(storage_.size());
+    for (const std::string& name : storage_) {
+        names.push_back(&name);
+    }
+    std::unique_ptr<Table> table = build(std::move(names));
+    table_.store(table.get(), std::memory_order_release);
+    // A reader may still be inside find() on the old table
+    retired_.push_back(std::move(current_));
+    current_ = std::move(table);
+}
+
+InstrumentId InstrumentRegistry::intern(std::string_view name) {
+    InstrumentId id = find(name);
+    if (id != kNoInstrument) {
+        return id;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t before = storage_.size();
+    id = add_locked(name);
+    if (storage_.size() != before) {
+        publish_locked();
+    }
+    return id;
+}
+
+void InstrumentRegistry::intern(const std::vector<std::string>& names) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t before = storage_.size();
+    for (const std::string& name : names) {
+        add_locked(name);
+    }
+    if (storage_.size() != before) {
+        publish_locked();
+    }
+}
+
+InstrumentId InstrumentRegistry::find(std::string_view name) const {
+    const Table* table = table_.load(std::memory_order_acquire);
+    uint64_t hash = hash_name(name);
+    uint32_t seed = table->seeds[(hash >> 32) & table->bucket_mask];
+    InstrumentId id = table->slots[slot_of(hash, seed, table->slot_mask)];
+    return id != kNoInstrument && *table->names[id] == name ? id : kNoInstrument;
+}
+
+const std::string& InstrumentRegistry::name(InstrumentId id) const {
+    return *table_.load(std::memory_order_acquire)->names[id];
+}
+
+size_t InstrumentRegistry::size() const {
+    return table_.load(std::memory_order_acquire)->names.size();
+}
+
+std::string_view InstrumentRegistry::instrument_of(std::string_view channel) {
+    size_t begin = channel.find('.');
+    if (begin == std::string_view::npos) {
+        return channel;
+    }
+    // user.<kind>.<instrument>...
+    if (channel.substr(0, begin) == "user") {
+        begin = channel.find('.', begin + 1);
+        if (begin == std::string_view::npos) {
+            return channel;
+        }
+    }
+    size_t end = channel.find('.', begin + 1);
+    std::string_view segment =
+        channel.substr(begin + 1, end == std::string_view::npos ? std::string_view::npos : end - begin - 1);
+    // trades.<kind>.<currency>.<interval> and the like span many instruments
+    if (segment == "future" || segment == "option" || segment == "spread" || segment == "combo" ||
+        segment == "future_combo" || segment == "option_combo" || segment == "any") {
+        return {};
+    }
+    return segment;
+}
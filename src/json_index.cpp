@@ -0,0 +1,244 @@
+#include "../include/json_index.h"
+#include <cstring>
+#if defined(__AVX2__) || defined(__SSE2__) || defined(__PCLMUL__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// One bit per byte of a 64-byte block
+struct BlockMasks {
+    uint64_t quote = 0;
+    uint64_t backslash = 0;
+    uint64_t op = 0;     // { } [ ] : ,
+    uint64_t space = 0;  // ' ' \t \n \r
+};
+
+#if defined(__AVX2__)
+
+uint64_t movemask(__m256i lo, __m256i hi) {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(lo)) |
+           (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hi))) << 32);
+}
+
+void classify(const char* p, BlockMasks& m) {
+    __m256i v[2] = {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)),
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32))};
+    __m256i quote[2], backslash[2], op[2], space[2];
+    for (int i = 0; i < 2; ++i) {
+        auto eq = [](__m256i x, char c) { return _mm256_cmpeq_epi8(x, _mm256_set1_epi8(c)); };
+        // '[' and ']' differ from '{' and '}' only in bit 0x20
+        __m256i folded = _mm256_or_si256(v[i], _mm256_set1_epi8(0x20));
+        quote[i] = eq(v[i], '"');
+        backslash[i] = eq(v[i], '\\');
+        op[i] = _mm256_or_si256(_mm256_or_si256(eq(folded, '{'), eq(folded, '}')),
+                                _mm256_or_si256(eq(v[i], ':'), eq(v[i], ',')));
+        space[i] = _mm256_or_si256(_mm256_or_si256(eq(v[i], ' '), eq(v[i], '\n')),
+                                   _mm256_or_si256(eq(v[i], '\r'), eq(v[i], '\t')));
+    }
+    m.quote = movemask(quote[0], quote[1]);
+    m.backslash = movemask(backslash[0], backslash[1]);
+    m.op = movemask(op[0], op[1]);
+    m.space = movemask(space[0], space[1]);
+}
+
+#elif defined(__SSE2__)
+
+void classify(const char* p, BlockMasks& m) {
+    for (int i = 0; i < 4; ++i) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+        auto eq = [v](char c) { return _mm_cmpeq_epi8(v, _mm_set1_epi8(c)); };
+        auto bits = [i](__m128i x) {
+            return static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(x))) << (16 * i);
+        };
+        // '[' and ']' differ from '{' and '}' only in bit 0x20
+        __m128i folded = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        __m128i open = _mm_cmpeq_epi8(folded, _mm_set1_epi8('{'));
+        __m128i close = _mm_cmpeq_epi8(folded, _mm_set1_epi8('}'));
+        m.quote |= bits(eq('"'));
+        m.backslash |= bits(eq('\\'));
+        m.op |= bits(_mm_or_si128(_mm_or_si128(open, close), _mm_or_si128(eq(':'), eq(','))));
+        m.space |= bits(_mm_or_si128(_mm_or_si128(eq(' '), eq('\n')), _mm_or_si128(eq('\r'), eq('\t'))));
+    }
+}
+
+#else
+
+void classify(const char* p, BlockMasks& m) {
+    for (int i = 0; i < 64; ++i) {
+        uint64_t bit = uint64_t{1} << i;
+        switch (p[i]) {
+            case '"': m.quote |= bit; break;
+            case '\\': m.backslash |= bit; break;
+            case '{': case '}': case '[': case ']': case ':': case ',': m.op |= bit; break;
+            case ' ': case '\t': case '\n': case '\r': m.space |= bit; break;
+            default: break;
+        }
+    }
+}
+
+#endif
+
+// Bit i is the xor of bits 0..i: set from an opening quote up to (not
+// including) its closing quote
+uint64_t prefix_xor(uint64_t x) {
+#if defined(__PCLMUL__)
+    __m128i product = _mm_clmulepi64_si128(_mm_set_epi64x(0, static_cast<int64_t>(x)), _mm_set1_epi8(-1), 0);
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(product));
+#else
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+#endif
+}
+
+// Bytes preceded by an odd run of backslashes. Adding a run that starts
+// on an odd bit to the backslash mask carries out of it, so the carries mark
+// where odd-started runs end; a run starting on an even bit has no carry.
+// Comparing run ends with the even/odd pattern picks the escaped bytes.
+// 'carry' is set when the block ends inside an odd run, i.e. the first byte
+// of the next block is escaped.
+uint64_t find_escaped(uint64_t backslash, uint64_t& carry) {
+    constexpr uint64_t kEven = 0x5555555555555555ULL;
+    backslash &= ~carry;  // an escaped backslash starts no run
+    uint64_t follows_backslash = (backslash << 1) | carry;
+    uint64_t odd_starts = backslash & ~kEven & ~follows_backslash;
+    uint64_t even_started;
+    carry = __builtin_add_overflow(odd_starts, backslash, &even_started) ? 1 : 0;
+    uint64_t invert = even_started << 1;
+    return (kEven ^ invert) & follows_backslash;
+}
+
+}  // namespace
+
+bool JsonIndex::build(std::string_view text) {
+    text_ = text;
+    count_ = 0;
+    matched_ = false;
+    if (text.size() >= UINT32_MAX) {
+        return false;
+    }
+    // At most one entry per byte; the vector only ever grows
+    if (positions_.size() < text.size() + 1) {
+        positions_.resize(text.size() + 1);
+    }
+    uint32_t* out = positions_.data();
+
+    uint64_t escape_carry = 0;
+    uint64_t in_string_carry = 0;  // all ones while a string spans blocks
+    uint64_t scalar_carry = 0;     // previous block ended inside a number or literal
+    char tail[64];
+    for (size_t base = 0; base < text.size(); base += 64) {
+        const char* block = text.data() + base;
+        if (text.size() - base < 64) {
+            std::memset(tail, ' ', sizeof(tail));
+            std::memcpy(tail, block, text.size() - base);
+            block = tail;
+        }
+        BlockMasks m;
+        classify(block, m);
+
+        uint64_t quote = m.quote & ~find_escaped(m.backslash, escape_carry);
+        uint64_t in_string = prefix_xor(quote) ^ in_string_carry;  // opening quotes included
+        in_string_carry = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+
+        uint64_t scalar = ~(m.op | m.space | quote | in_string);
+        uint64_t scalar_start = scalar & ~((scalar << 1) | scalar_carry);
+        scalar_carry = scalar >> 63;
+
+        uint64_t structural = (m.op & ~in_string) | (quote & in_string) | scalar_start;
+        while (structural != 0) {
+            *out++ = static_cast<uint32_t>(base + static_cast<size_t>(__builtin_ctzll(structural)));
+            structural &= structural - 1;
+        }
+    }
+    count_ = static_cast<size_t>(out - positions_.data());
+    return in_string_carry == 0;
+}
+
+size_t JsonIndex::skip_value(size_t i) const {
+    char c = text_[positions_[i]];
+    if (c != '{' && c != '[') {
+        return i + 1;
+    }
+    if (!matched_) {
+        match_brackets();
+    }
+    size_t close = closers_[i];
+    return close < count_ ? close + 1 : count_;
+}
+
+void JsonIndex::match_brackets() const {
+    if (closers_.size() < count_) {
+        closers_.resize(count_);
+    }
+    // Open entries waiting for their bracket are chained through closers_
+    // itself: each one stores the previously open entry
+    uint32_t open = UINT32_MAX;
+    for (size_t i = 0; i < count_; ++i) {
+        char c = text_[positions_[i]];
+        if (c == '{' || c == '[') {
+            closers_[i] = open;
+            open = static_cast<uint32_t>(i);
+        } else if ((c == '}' || c == ']') && open != UINT32_MAX) {
+            uint32_t outer = closers_[open];
+            closers_[open] = static_cast<uint32_t>(i);
+            open = outer;
+        }
+    }
+    while (open != UINT32_MAX) {  // unclosed: skips run to the end
+        uint32_t outer = closers_[open];
+        closers_[open] = static_cast<uint32_t>(count_);
+        open = outer;
+    }
+    matched_ = true;
+}
+
+std::string_view JsonIndex::value_text(size_t i) const {
+    size_t begin = positions_[i];
+    char c = text_[begin];
+    size_t end;
+    if (c == '{' || c == '[') {
+        size_t next = skip_value(i);
+        end = next <= count_ && next > i + 1 ? positions_[next - 1] + 1 : text_.size();
+    } else {
+        // Scalars and strings run up to the next structural, minus whitespace
+        end = i + 1 < count_ ? positions_[i + 1] : text_.size();
+        while (end > begin && (text_[end - 1] == ' ' || text_[end - 1] == '\n' ||
+                               text_[end - 1] == '\r' || text_[end - 1] == '\t')) {
+            --end;
+        }
+    }
+    return text_.substr(begin, end - begin);
+}
+
+std::string_view JsonIndex::find(std::initializer_list<std::string_view> path) const {
+    size_t i = 0;
+    for (std::string_view key : path) {
+        size_t found = count_;
+        for_each_member(i, [&](std::string_view name, size_t value) {
+            if (name != key) {
+                return true;
+            }
+            found = value;
+            return false;
+        });
+        if (found == count_) {
+            return {};
+        }
+        i = found;
+    }
+    return i < count_ ? value_text(i) : std::string_view();
+}
+
+std::string_view JsonIndex::find_string(std::initializer_list<std::string_view> path) const {
+    std::string_view value = find(path);
+    if (value.size() < 2 || value.front() != '"') {
+        return {};
+    }
+    return value.substr(1, value.size() - 2);
+}
@@ -0,0 +1,133 @@
+#include "../include/json_scanner.h"
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static bool read_hex4(const char*& p, const char* end, uint32_t& out) {
+    if (end - p < 4) return false;
+    out = 0;
+    for (int i = 0; i < 4; ++i) {
+        int v = hex_value(p[i]);
+        if (v < 0) return false;
+        out = (out << 4) | static_cast<uint32_t>(v);
+    }
+    p += 4;
+    return true;
+}
+
+static void append_utf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+bool JsonScanner::read_string(const char*& p, const char* end, std::string_view& out) {
+    const char* begin = ++p;  // past the opening quote
+    // Fast path: no escapes, the view points into the frame
+    while (p != end && *p != '"' && *p != '\\') {
+        if (static_cast<unsigned char>(*p) < 0x20) return false;
+        ++p;
+    }
+    if (p == end) return false;
+    if (*p == '"') {
+        out = std::string_view(begin, static_cast<size_t>(p - begin));
+        ++p;
+        return true;
+    }
+
+    scratch_.assign(begin, static_cast<size_t>(p - begin));
+    while (p != end && *p != '"') {
+        char c = *p++;
+        if (static_cast<unsigned char>(c) < 0x20) return false;
+        if (c != '\\') {
+            scratch_ += c;
+            continue;
+        }
+        if (p == end) return false;
+        switch (*p++) {
+            case '"': scratch_ += '"'; break;
+            case '\\': scratch_ += '\\'; break;
+            case '/': scratch_ += '/'; break;
+            case 'b': scratch_ += '\b'; break;
+            case 'f': scratch_ += '\f'; break;
+            case 'n': scratch_ += '\n'; break;
+            case 'r': scratch_ += '\r'; break;
+            case 't': scratch_ += '\t'; break;
+            case 'u': {
+                uint32_t cp = 0;
+                if (!read_hex4(p, end, cp)) return false;
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    // High surrogate: must be followed by \uDC00-\uDFFF
+                    uint32_t low = 0;
+                    if (end - p < 2 || p[0] != '\\' || p[1] != 'u') return false;
+                    p += 2;
+                    if (!read_hex4(p, end, low) || low < 0xDC00 || low > 0xDFFF) return false;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                    return false;
+                }
+                append_utf8(scratch_, cp);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    if (p == end) return false;
+    ++p;
+    out = scratch_;
+    return true;
+}
+
+bool JsonScanner::read_number(const char*& p, const char* end, std::string_view& out, bool& is_integer) {
+    const char* begin = p;
+    if (p != end && *p == '-') ++p;
+    if (p == end) return false;
+    if (*p == '0') {
+        ++p;
+    } else if (*p >= '1' && *p <= '9') {
+        while (p != end && *p >= '0' && *p <= '9') ++p;
+    } else {
+        return false;
+    }
+    is_integer = true;
+    if (p != end && *p == '.') {
+        is_integer = false;
+        ++p;
+        if (p == end || *p < '0' || *p > '9') return false;
+        while (p != end && *p >= '0' && *p <= '9') ++p;
+    }
+    if (p != end && (*p == 'e' || *p == 'E')) {
+        is_integer = false;
+        ++p;
+        if (p != end && (*p == '+' || *p == '-')) ++p;
+        if (p == end || *p < '0' || *p > '9') return false;
+        while (p != end && *p >= '0' && *p <= '9') ++p;
+    }
+    out = std::string_view(begin, static_cast<size_t>(p - begin));
+    return true;
+}
+
+bool JsonScanner::read_literal(const char*& p, const char* end, std::string_view literal) {
+    if (static_cast<size_t>(end - p) < literal.size() || std::string_view(p, literal.size()) != literal) {
+        return false;
+    }
+    p += literal.size();
+    return true;
+}
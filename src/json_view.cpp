@@ -0,0 +1,42 @@
+#include "../include/json_view.h"
+
+JsonView JsonView::operator[](std::string_view key) const {
+    JsonView found;
+    for_each_member([&](std::string_view name, JsonView value) {
+        if (name != key) {
+            return true;
+        }
+        found = value;
+        return false;
+    });
+    return found;
+}
+
+JsonView JsonView::operator[](size_t position) const {
+    JsonView found;
+    size_t current = 0;
+    for_each_element([&](JsonView element) {
+        if (current++ != position) {
+            return true;
+        }
+        found = element;
+        return false;
+    });
+    return found;
+}
+
+size_t JsonView::size() const {
+    size_t count = 0;
+    if (is_object()) {
+        for_each_member([&](std::string_view, JsonView) {
+            ++count;
+            return true;
+        });
+    } else if (is_array()) {
+        for_each_element([&](JsonView) {
+            ++count;
+            return true;
+        });
+    }
+    return count;
+}
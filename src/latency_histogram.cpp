@@ -0,0 +1,80 @@
+#include "../include/latency_histogram.h"
+
+LatencyHistogram::LatencyHistogram() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t LatencyHistogram::bucket_of(uint64_t ns) {
+    if (ns < kSubBuckets) {
+        return static_cast<size_t>(ns);  // exact below 16ns
+    }
+    int msb = 63 - __builtin_clzll(ns);
+    int shift = msb - kSubBits;
+    size_t sub = static_cast<size_t>((ns >> shift) & (kSubBuckets - 1));
+    return static_cast<size_t>(shift + 1) * kSubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::value_of(size_t bucket) {
+    size_t group = bucket / kSubBuckets;
+    uint64_t sub = bucket % kSubBuckets;
+    if (group == 0) {
+        return sub;
+    }
+    uint64_t width = uint64_t{1} << (group - 1);
+    uint64_t lower = (kSubBuckets + sub) << (group - 1);
+    return lower + width / 2;  // middle of the bucket
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds value) {
+    uint64_t ns = value.count() > 0 ? static_cast<uint64_t>(value.count()) : 0;
+    buckets_[bucket_of(ns)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(ns, std::memory_order_relaxed);
+    // Single writer: plain load/store is enough for min and max
+    if (ns < min_.load(std::memory_order_relaxed)) min_.store(ns, std::memory_order_relaxed);
+    if (ns > max_.load(std::memory_order_relaxed)) max_.store(ns, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(UINT64_MAX, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds LatencyHistogram::min() const {
+    uint64_t ns = min_.load(std::memory_order_relaxed);
+    return std::chrono::nanoseconds(ns == UINT64_MAX ? 0 : static_cast<int64_t>(ns));
+}
+
+std::chrono::nanoseconds LatencyHistogram::max() const {
+    return std::chrono::nanoseconds(static_cast<int64_t>(max_.load(std::memory_order_relaxed)));
+}
+
+std::chrono::nanoseconds LatencyHistogram::mean() const {
+    uint64_t n = count();
+    return std::chrono::nanoseconds(n == 0 ? 0 : static_cast<int64_t>(sum_.load(std::memory_order_relaxed) / n));
+}
+
+std::chrono::nanoseconds LatencyHistogram::percentile(double p) const {
+    uint64_t n = count();
+    if (n == 0) {
+        return std::chrono::nanoseconds(0);
+    }
+    if (p < 0.0) p = 0.0;
+    if (p > 100.0) p = 100.0;
+    uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(n - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::chrono::nanoseconds(static_cast<int64_t>(value_of(i)));
+        }
+    }
+    return max();
+}
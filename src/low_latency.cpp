@@ -0,0 +1,35 @@
+#include "../include/low_latency.h"
+#include <iostream>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+bool pin_current_thread(const std::vector<int>& cpus) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    if (CPU_COUNT(&set) > 0 && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+        return true;
+    }
+#endif
+    std::cerr << "⚠️ Could not pin thread to CPUs";
+    for (int cpu : cpus) {
+        std::cerr << ' ' << cpu;
+    }
+    std::cerr << std::endl;
+    return false;
+}
+
+void run_spinning(boost::asio::io_context& ioc) {
+    // poll() checks the reactor with a zero timeout and runs whatever is
+    // ready inline; like run(), it stops the context once no work is left
+    while (!ioc.stopped()) {
+        ioc.poll();
+    }
+}
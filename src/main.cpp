@@ -1,9 +1,6 @@
 #include <iostream>
+#include <optional>
 #include "../include/api.h" 
-#include "json.hpp"
-
-
-using json = nlohmann::json;
 
 
 int main() {
@@ -29,6 +26,15 @@ int main() {
     std::cout << std::endl;
     std::cout << "\u2705 Authentication successful!" << std::endl;
 
+    // No typed schema for the account summary: a few fields read from the
+    // generic response, which lives in the API's arena until the next request
+    const ArenaJson& summary = api.call("private/get_account_summary", {{"currency", "BTC"}}, access_token);
+    auto account = summary.find("result");
+    if (account != summary.end() && account->is_object()) {
+        std::cout << "💰 Equity: " << account->value("equity", 0.0) << " BTC, available: "
+                  << account->value("available_funds", 0.0) << " BTC" << std::endl;
+    }
+
     int choice;
     while (true) {
         std::cout << "************************************************************\n";
@@ -64,28 +70,12 @@ int main() {
                 }
 
                 std::cout << "\n\U0001F680 Placing order...\n";
-                std::string order_response = api.place_order(access_token, instrument_name, amount, order_type, price);
-
-                // ✅ Parse JSON response
-                json order_json = json::parse(order_response, nullptr, false);
-                if (order_json.is_discarded()) {
-                    std::cerr << "\u274C Error: Failed to parse JSON response!" << std::endl;
-                    continue;
-                }
-                std::cout << "ORDER PLACED SUCCESSFULLY 💰" << std::endl;
-                // ✅ Debugging: Print Order Response
-                std::cout << "ORDER ID: " << order_json.dump(4) << "\n";
-
-                // ✅ Extract order ID safely
-                if (!order_json.contains("result") || 
-                    !order_json["result"].contains("order") || 
-                    !order_json["result"]["order"].contains("order_id")) {
-                    
-                    //std::cerr << "\u274C Error: 'order_id' missing in response!" << std::endl;
+                std::string order_id = api.place_order(access_token, instrument_name, amount, order_type, price);
+                if (order_id.empty()) {
                     continue;
                 }
 
-                std::string order_id = order_json["result"]["order"]["order_id"];
+                std::cout << "ORDER PLACED SUCCESSFULLY 💰" << std::endl;
                 std::cout << "\U0001F680 Order placed successfully! Order ID: " << order_id << "\n";
                 break;
             }
@@ -95,13 +85,10 @@ int main() {
                 std::string order_id;
                 std::cin >> order_id;
 
-                json cancel_response = api.cancel_order(access_token, order_id);
-
                 std::cout << "🚀 Attempting to cancel order: " << order_id << "\n";
-                std::cout << "Cancel Order Raw Response: " << cancel_response.dump(4) << "\n";
+                std::optional<Order> cancelled = api.cancel_order(access_token, order_id);
 
-                if (cancel_response.contains("result") && cancel_response["result"].contains("order_state") &&
-                    cancel_response["result"]["order_state"] == "cancelled") {
+                if (cancelled && cancelled->order_state == "cancelled") {
                     std::cout << "\U00002705 Order " << order_id << " is now cancelled.\n";
                 } else {
                     std::cerr << "\U0001F6AB Failed to cancel order. Check response above.\n";
@@ -125,12 +112,11 @@ int main() {
 
                 std::cout << "🚀 Modifying order..." << std::endl;
 
-                json modify_response = api.modify_order(access_token, order_id, new_amount, new_price);
+                std::optional<OrderPlacement> modified = api.modify_order(access_token, order_id, new_amount, new_price);
 
                 // ✅ Extract Order ID from response
-                if (modify_response.contains("result") && modify_response["result"].contains("order") &&
-                    modify_response["result"]["order"].contains("order_id")) {
-                    std::cout << "✅ Order modified successfully! New Order ID: "<< modify_response["result"]["order"]["order_id"] << std::endl;
+                if (modified && !modified->order.order_id.empty()) {
+                    std::cout << "✅ Order modified successfully! New Order ID: "<< modified->order.order_id << std::endl;
                 } else {
                 std::cerr << "❌ Failed to modify order!" << std::endl;
                 }
@@ -145,23 +131,25 @@ int main() {
                 std::cout << "🚀 Enter instrument name for order book (e.g., BTC-PERPETUAL): ";
                 std::cin >> instrument;
 
-                json order_book_response = api.get_order_book(instrument);
+                // ✅ Only the fields below are converted; the bid/ask arrays are skipped
+                std::optional<JsonView> book = api.get_order_book_view(instrument);
 
-                if (order_book_response.contains("error")) {
+                if (!book) {
                     std::cerr << "❌ Failed to fetch order book!\n";
                     break;
                 }
 
                 // ✅ Extract key order book details
-                double best_ask = order_book_response["best_ask_price"];
-                double best_bid = order_book_response["best_bid_price"];
-                double last_price = order_book_response["last_price"];
-                double high_24h = order_book_response["stats"]["high"];
-                double low_24h = order_book_response["stats"]["low"];
-                double volume_24h = order_book_response["stats"]["volume"];
-                double index_price = order_book_response["index_price"];
-                double mark_price = order_book_response["mark_price"];
-                double funding_rate = order_book_response["funding_8h"];
+                JsonView stats = (*book)["stats"];
+                double best_ask = (*book)["best_ask_price"].value_or(0.0);
+                double best_bid = (*book)["best_bid_price"].value_or(0.0);
+                double last_price = (*book)["last_price"].value_or(0.0);
+                double high_24h = stats["high"].value_or(0.0);
+                double low_24h = stats["low"].value_or(0.0);
+                double volume_24h = stats["volume"].value_or(0.0);
+                double index_price = (*book)["index_price"].value_or(0.0);
+                double mark_price = (*book)["mark_price"].value_or(0.0);
+                double funding_rate = (*book)["funding_8h"].value_or(0.0);
 
                 std::cout << "\n=========================================" << std::endl;
                 std::cout << "📖 ORDER BOOK SUMMARY - " << instrument << std::endl;
@@ -0,0 +1,267 @@
+#include "../include/order_book.h"
+#include <iostream>
+
+OrderBook::OrderBook(std::string instrument, FixedScale tick)
+    : instrument_(std::move(instrument)),
+      tick_(tick),
+      bids_(PriceLadder::Side::Bid),
+      asks_(PriceLadder::Side::Ask) {}
+
+void OrderBook::apply_levels(PriceLadder& side, const std::vector<BookLevelUpdate>& levels) {
+    for (const auto& level : levels) {
+        // Exact for on-grid prices, which is all Deribit sends
+        Price price(tick_.to_units_nearest(level.price));
+        side.set(price, level.action == BookLevelUpdate::Action::Delete ? 0.0 : to_double(level.amount));
+    }
+}
+
+void OrderBook::apply_levels(PriceLadder& side, const BookLevelRecord* begin, const BookLevelRecord* end) {
+    for (const BookLevelRecord* level = begin; level != end; ++level) {
+        Price price(tick_.to_units_nearest(Decimal{level->price_mantissa, level->price_scale}));
+        double amount = level->action == BookLevelUpdate::Action::Delete
+            ? 0.0 : to_double(Decimal{level->amount_mantissa, level->amount_scale});
+        side.set(price, amount);
+    }
+}
+
+bool OrderBook::begin(bool snapshot, int64_t prev_change_id) {
+    if (snapshot) {
+        bids_.clear();
+        asks_.clear();
+        valid_ = true;
+        return true;
+    }
+    // ✅ Deltas only make sense on top of the exact previous state
+    if (!valid_) {
+        return false;
+    }
+    if (prev_change_id != change_id_) {
+        valid_ = false;
+        return false;
+    }
+    return true;
+}
+
+bool OrderBook::apply(const BookUpdate& update) {
+    if (!begin(update.snapshot, update.prev_change_id)) {
+        return false;
+    }
+    apply_levels(bids_, update.bids);
+    apply_levels(asks_, update.asks);
+    change_id_ = update.change_id;
+    timestamp_ = update.timestamp;
+    check_complete();
+    return true;
+}
+
+bool OrderBook::apply(const BookRecord& record) {
+    if (!begin((record.header.flags & BookRecord::kSnapshot) != 0, record.prev_change_id)) {
+        return false;
+    }
+    const BookLevelRecord* levels = record.levels();
+    apply_levels(bids_, levels, levels + record.bid_count);
+    apply_levels(asks_, levels + record.bid_count, levels + record.header.count);
+    change_id_ = record.change_id;
+    timestamp_ = record.header.timestamp;
+    check_complete();
+    return true;
+}
+
+void OrderBook::check_complete() {
+    // A side that dropped a level no longer matches the feed; it stays
+    // invalid until a snapshot clears it
+    if (bids_.truncated() || asks_.truncated()) {
+        valid_ = false;
+    }
+}
+
+std::optional<BookLevel> OrderBook::best_bid() const {
+    if (bids_.empty()) return std::nullopt;
+    return BookLevel{bids_.best_price(), bids_.best_amount()};
+}
+
+std::optional<BookLevel> OrderBook::best_ask() const {
+    if (asks_.empty()) return std::nullopt;
+    return BookLevel{asks_.best_price(), asks_.best_amount()};
+}
+
+static std::vector<BookLevel> collect_levels(const PriceLadder& side, size_t depth) {
+    std::vector<BookLevel> levels;
+    if (depth == 0) return levels;
+    levels.reserve(depth);
+    side.for_each([&](Price price, double amount) {
+        levels.push_back({price, amount});
+        return levels.size() < depth;
+    });
+    return levels;
+}
+
+std::vector<BookLevel> OrderBook::bids(size_t depth) const {
+    return collect_levels(bids_, depth);
+}
+
+std::vector<BookLevel> OrderBook::asks(size_t depth) const {
+    return collect_levels(asks_, depth);
+}
+
+std::optional<FillEstimate> OrderBook::estimate_fill(bool buy, double amount) const {
+    const PriceLadder& side = buy ? asks_ : bids_;
+    if (side.empty()) {
+        return std::nullopt;
+    }
+    SweepResult sweep = side.sweep(amount);
+    double tick_size = tick_.to_double(1);
+    double best = tick_.to_double(side.best_price().units);
+
+    FillEstimate estimate;
+    estimate.filled = sweep.filled;
+    estimate.average_price = sweep.average_ticks() * tick_size;
+    estimate.worst_price = tick_.to_double(sweep.worst.units);
+    if (sweep.filled > 0.0 && best != 0.0) {
+        double move = buy ? estimate.average_price - best : best - estimate.average_price;
+        estimate.slippage_bps = move / best * 1e4;
+    }
+    return estimate;
+}
+
+double OrderBook::depth_within_bps(PriceLadder::Side side, double bps) const {
+    const PriceLadder& ladder = side == PriceLadder::Side::Bid ? bids_ : asks_;
+    if (ladder.empty()) {
+        return 0.0;
+    }
+    // Whole ticks inside the band; the best price is in ticks already
+    double ticks = static_cast<double>(ladder.best_price().units) * bps / 1e4;
+    return ladder.depth_within(static_cast<int64_t>(ticks + 1e-9));
+}
+
+void OrderBook::fill_snapshot(BookSnapshot& out) const {
+    out.valid = valid_;
+    out.change_id = change_id_;
+    out.timestamp = timestamp_;
+    out.tick = tick_;
+    out.bid_count = 0;
+    out.ask_count = 0;
+    bids_.for_each([&](Price price, double amount) {
+        out.bids[out.bid_count++] = {price, amount};
+        return out.bid_count < BookSnapshot::kDepth;
+    });
+    asks_.for_each([&](Price price, double amount) {
+        out.asks[out.ask_count++] = {price, amount};
+        return out.ask_count < BookSnapshot::kDepth;
+    });
+}
+
+OrderBookManager::OrderBookManager(WebSocketClient& ws) : ws_(ws) {
+    connection_handler_ =
+        ws_.add_connection_handler([this](WebSocketClient::ConnectionEvent event) { on_connection(event); });
+}
+
+OrderBookManager::~OrderBookManager() {
+    ws_.remove_connection_handler(connection_handler_);
+}
+
+void OrderBookManager::track(const std::string& instrument, double tick_size) {
+    track(BookSubscription::incremental(instrument, BookSubscription::Interval::Raw), tick_size);
+}
+
+void OrderBookManager::track(const BookSubscription& spec, double tick_size) {
+    if (!spec.is_valid()) {
+        std::cerr << "❌ Unsupported order book subscription: " << spec.channel() << std::endl;
+        return;
+    }
+    InstrumentId id = InstrumentRegistry::instance().intern(spec.instrument);
+    SeqLock<BookSnapshot>* published;
+    {
+        std::lock_guard<std::mutex> lock(snapshots_mutex_);
+        published = &snapshots_.emplace(id);
+    }
+    // The feed reads books_ on the io_context thread, so only that thread
+    // may grow it
+    post(ws_.context(), [this, id, published, instrument = spec.instrument, channel = spec.channel(),
+                         tick = FixedScale::from_double(tick_size)] {
+        books_.emplace(id, instrument, tick, *published).channel = channel;
+        subscribe(channel);
+    });
+}
+
+const OrderBook* OrderBookManager::book(const std::string& instrument) const {
+    return book(InstrumentRegistry::instance().find(instrument));
+}
+
+const OrderBook* OrderBookManager::book(InstrumentId instrument) const {
+    const Tracked* tracked = books_.find(instrument);
+    return tracked ? &tracked->book : nullptr;
+}
+
+const SeqLock<BookSnapshot>* OrderBookManager::snapshot(InstrumentId instrument) const {
+    std::lock_guard<std::mutex> lock(snapshots_mutex_);
+    return snapshots_.find(instrument);
+}
+
+void OrderBookManager::subscribe(const std::string& channel) {
+    ws_.subscribe_events({channel}, [this](const EventBuffer& events) { on_events(events); });
+}
+
+void OrderBookManager::on_events(const EventBuffer& events) {
+    events.for_each([this](const EventHeader& header) {
+        if (header.type == EventType::Book) {
+            on_book(event_cast<BookRecord>(header));
+        }
+    });
+}
+
+void OrderBookManager::on_book(const BookRecord& record) {
+    Tracked* tracked = books_.find(record.header.instrument);
+    if (tracked == nullptr) {
+        return;
+    }
+    OrderBook& book = tracked->book;
+
+    bool was_valid = book.is_valid();
+    if (!book.apply(record)) {
+        // Only the first broken delta triggers a resync; the rest are dropped
+        // until the new snapshot arrives
+        if (was_valid) {
+            publish(*tracked);
+            resync(*tracked);
+        }
+        return;
+    }
+
+    publish(*tracked);
+    if (!book.is_valid()) {
+        // Resubscribing would bring back the same oversized snapshot
+        std::cerr << "⚠ Order book " << book.instrument() << " spans more than " << PriceLadder::kMaxLevels
+                  << " ticks and cannot be held, stale until the next snapshot" << std::endl;
+        return;
+    }
+    if (on_update_) {
+        on_update_(book);
+    }
+}
+
+void OrderBookManager::resync(Tracked& tracked) {
+    std::cerr << "⚠ Order book gap on " << tracked.book.instrument() << " after change_id "
+              << tracked.book.change_id() << ", resubscribing for a snapshot" << std::endl;
+    ws_.unsubscribe({tracked.channel});
+    subscribe(tracked.channel);
+}
+
+void OrderBookManager::publish(Tracked& tracked) {
+    BookSnapshot snapshot;
+    tracked.book.fill_snapshot(snapshot);
+    tracked.published.store(snapshot);
+}
+
+void OrderBookManager::on_connection(WebSocketClient::ConnectionEvent event) {
+    if (event != WebSocketClient::ConnectionEvent::Disconnected) {
+        return;
+    }
+    // Updates missed while down cannot be replayed; the client resubscribes
+    // on reconnect and the snapshot that follows makes each book valid again
+    books_.for_each([this](InstrumentId, Tracked& tracked) {
+        tracked.book.invalidate();
+        publish(tracked);
+    });
+    std::cerr << "⚠ Connection lost, " << books_.size() << " order book(s) stale until the next snapshot" << std::endl;
+}
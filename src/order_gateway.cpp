@@ -0,0 +1,243 @@
+#include "../include/order_gateway.h"
+#include "../include/rpc_encoder.h"
+#include <iostream>
+
+namespace {
+
+// What RateLimiter::classify() gives the methods sent here
+constexpr RateLimiter::Class kOrder{RateLimiter::Pool::MatchingEngine, RateLimiter::Priority::Order};
+constexpr RateLimiter::Class kEdit{RateLimiter::Pool::MatchingEngine, RateLimiter::Priority::Edit};
+constexpr RateLimiter::Class kCancel{RateLimiter::Pool::MatchingEngine, RateLimiter::Priority::Cancel};
+constexpr RateLimiter::Class kAuth{RateLimiter::Pool::NonMatchingEngine, RateLimiter::Priority::Other};
+
+}  // namespace
+
+// Orders may be sent from any thread, so each thread encodes into its own buffer
+static thread_local RpcEncoder encoder;
+
+bool OrderGateway::PendingTable::insert(uint64_t id, Callback& on_done) {
+    Slot& slot = slots_[id % kSlots];
+    uint64_t expected = kFree;
+    if (!slot.id.compare_exchange_strong(expected, kBusy, std::memory_order_acquire)) {
+        return false;
+    }
+    slot.on_done = std::move(on_done);
+    slot.id.store(id, std::memory_order_release);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+OrderGateway::Callback OrderGateway::PendingTable::take(uint64_t id) {
+    if (id == kFree || id == kBusy) {
+        return {};
+    }
+    Slot& slot = slots_[id % kSlots];
+    uint64_t expected = id;
+    if (!slot.id.compare_exchange_strong(expected, kBusy, std::memory_order_acquire)) {
+        return {};
+    }
+    Callback on_done = std::move(slot.on_done);
+    slot.on_done = nullptr;
+    slot.id.store(kFree, std::memory_order_release);
+    count_.fetch_sub(1, std::memory_order_relaxed);
+    return on_done;
+}
+
+std::vector<OrderGateway::Callback> OrderGateway::PendingTable::take_all() {
+    std::vector<Callback> taken;
+    for (Slot& slot : slots_) {
+        uint64_t id = slot.id.load(std::memory_order_acquire);
+        if (id == kFree || id == kBusy) {
+            continue;
+        }
+        if (Callback on_done = take(id)) {
+            taken.push_back(std::move(on_done));
+        }
+    }
+    return taken;
+}
+
+OrderGateway::OrderGateway(WebSocketClient& ws) : OrderGateway(ws, own_limiter_) {}
+
+OrderGateway::OrderGateway(WebSocketClient& ws, RateLimiter& limiter) : ws_(ws), limiter_(limiter) {
+    connection_handler_ =
+        ws_.add_connection_handler([this](WebSocketClient::ConnectionEvent event) { on_connection(event); });
+}
+
+OrderGateway::~OrderGateway() {
+    ws_.remove_connection_handler(connection_handler_);
+}
+
+OrderGateway::OrderGateway(WebSocketClient& ws, RateLimiter& limiter, const OrderGrids& grids)
+    : OrderGateway(ws, limiter) {
+    grids_ = &grids;
+}
+
+std::optional<OrderGrid> OrderGateway::grid_of(InstrumentId instrument) const {
+    return grids_ ? grids_->find(instrument) : std::nullopt;
+}
+
+void OrderGateway::on_connection(WebSocketClient::ConnectionEvent event) {
+    if (event == WebSocketClient::ConnectionEvent::Disconnected) {
+        for (Callback& on_done : pending_.take_all()) {
+            on_done({{"error", "Connection lost"}});
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(credentials_mutex_);
+        if (client_id_.empty()) {
+            return;  // never authenticated
+        }
+    }
+    // Runs before the client resubscribes, so private channels find the
+    // session authorized again
+    Callback on_done = [](json response) {
+        if (!response.contains("result")) {
+            std::cerr << "❌ Re-authentication after reconnect failed: " << response.dump() << std::endl;
+        }
+    };
+    send_auth(on_done);
+}
+
+uint64_t OrderGateway::send(uint64_t id, RateLimiter::Class request_class, std::string_view body,
+                            Callback& on_done) {
+    if (body.empty()) {
+        on_done({{"error", "Request too large to encode"}});
+        return 0;
+    }
+    // ✅ Same buckets as the REST requests of this account
+    limiter_.acquire(request_class);
+    // Register before writing: the response may arrive before send() returns
+    if (!pending_.insert(id, on_done)) {
+        std::cerr << "❌ Too many requests in flight on the order gateway" << std::endl;
+        on_done({{"error", "Too many requests in flight"}});
+        return 0;
+    }
+
+    try {
+        ws_.send(body);
+    } catch (const std::exception& e) {
+        if (Callback failed = pending_.take(id)) {
+            failed({{"error", e.what()}});
+        }
+        return 0;
+    }
+    return id;
+}
+
+uint64_t OrderGateway::authenticate(const std::string& client_id, const std::string& client_secret, Callback on_done) {
+    {
+        std::lock_guard<std::mutex> lock(credentials_mutex_);
+        client_id_ = client_id;
+        client_secret_ = client_secret;
+    }
+    return send_auth(on_done);
+}
+
+uint64_t OrderGateway::send_auth(Callback& on_done) {
+    uint64_t id = ws_.next_request_id();
+    json request;
+    {
+        std::lock_guard<std::mutex> lock(credentials_mutex_);
+        request = {
+            {"jsonrpc", "2.0"},
+            {"id", id},
+            {"method", "public/auth"},
+            {"params", {
+                {"grant_type", "client_credentials"},
+                {"client_id", client_id_},
+                {"client_secret", client_secret_}
+            }}
+        };
+    }
+    std::string body = request.dump();
+    return send(id, kAuth, body, on_done);
+}
+
+uint64_t OrderGateway::buy(const std::string& instrument, int amount, const std::string& type, double price, Callback on_done) {
+    return send_order(true, instrument, amount, type, price, on_done);
+}
+
+uint64_t OrderGateway::sell(const std::string& instrument, int amount, const std::string& type, double price, Callback on_done) {
+    return send_order(false, instrument, amount, type, price, on_done);
+}
+
+uint64_t OrderGateway::send_order(bool buy, const std::string& instrument, int amount, const std::string& type,
+                                  double price, Callback& on_done) {
+    std::optional<OrderGrid> grid = grid_of(InstrumentRegistry::instance().find(instrument));
+    if (!grid) {
+        uint64_t id = ws_.next_request_id();
+        return send(id, kOrder, buy ? encoder.buy(id, instrument, amount, type, price)
+                                    : encoder.sell(id, instrument, amount, type, price), on_done);
+    }
+    Decimal snapped_amount = grid->amount(amount);
+    if (snapped_amount.mantissa <= 0) {
+        on_done({{"error", "Amount below the instrument's minimum"}});
+        return 0;
+    }
+    Decimal snapped_price = grid->price(price, buy);
+    uint64_t id = ws_.next_request_id();
+    return send(id, kOrder, buy ? encoder.buy(id, instrument, snapped_amount, type, snapped_price)
+                                : encoder.sell(id, instrument, snapped_amount, type, snapped_price), on_done);
+}
+
+uint64_t OrderGateway::edit(const std::string& order_id, int new_amount, double new_price, Callback on_done) {
+    uint64_t id = ws_.next_request_id();
+    return send(id, kEdit, encoder.edit(id, order_id, new_amount, new_price), on_done);
+}
+
+uint64_t OrderGateway::edit(const std::string& order_id, InstrumentId instrument, bool buy, int new_amount,
+                            double new_price, Callback on_done) {
+    std::optional<OrderGrid> grid = grid_of(instrument);
+    if (!grid) {
+        return edit(order_id, new_amount, new_price, std::move(on_done));
+    }
+    Decimal snapped_amount = grid->amount(new_amount);
+    if (snapped_amount.mantissa <= 0) {
+        on_done({{"error", "Amount below the instrument's minimum"}});
+        return 0;
+    }
+    uint64_t id = ws_.next_request_id();
+    return send(id, kEdit, encoder.edit(id, order_id, snapped_amount, grid->price(new_price, buy)), on_done);
+}
+
+uint64_t OrderGateway::cancel(const std::string& order_id, Callback on_done) {
+    uint64_t id = ws_.next_request_id();
+    return send(id, kCancel, encoder.cancel(id, order_id), on_done);
+}
+
+uint64_t OrderGateway::buy(const std::string& instrument, Decimal amount, const std::string& type, Decimal price, Callback on_done) {
+    uint64_t id = ws_.next_request_id();
+    return send(id, kOrder, encoder.buy(id, instrument, amount, type, price), on_done);
+}
+
+uint64_t OrderGateway::sell(const std::string& instrument, Decimal amount, const std::string& type, Decimal price, Callback on_done) {
+    uint64_t id = ws_.next_request_id();
+    return send(id, kOrder, encoder.sell(id, instrument, amount, type, price), on_done);
+}
+
+uint64_t OrderGateway::edit(const std::string& order_id, Decimal new_amount, Decimal new_price, Callback on_done) {
+    uint64_t id = ws_.next_request_id();
+    return send(id, kEdit, encoder.edit(id, order_id, new_amount, new_price), on_done);
+}
+
+bool OrderGateway::on_message(std::string_view message) {
+    // Responses carry an id; subscription notifications carry a method instead
+    if (pending_.size() == 0 || message.find("\"id\"") == std::string_view::npos) {
+        return false;
+    }
+
+    json parsed = json::parse(message, nullptr, false);
+    if (parsed.is_discarded() || !parsed.contains("id") || !parsed["id"].is_number_unsigned()) {
+        return false;
+    }
+
+    Callback on_done = pending_.take(parsed["id"].get<uint64_t>());
+    if (!on_done) {
+        return false;
+    }
+    on_done(std::move(parsed));
+    return true;
+}
@@ -0,0 +1,14 @@
+#include "../include/order_grids.h"
+
+void OrderGrids::set(InstrumentId instrument, const OrderGrid& grid) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    grids_.emplace(instrument) = grid;
+}
+
+std::optional<OrderGrid> OrderGrids::find(InstrumentId instrument) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (const OrderGrid* grid = grids_.find(instrument)) {
+        return *grid;
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,311 @@
+#include "../include/price_ladder.h"
+#include <algorithm>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Levels summed per step of the depth kernels
+constexpr int64_t kChunk = 32;
+
+// Sweep helper: sum() adds up one chunk of levels and computes their
+// index-weighted sum (amount * index, which becomes the notional) without
+// reducing it; accept() folds that into a running vector total, which is
+// reduced once at the end. Only the plain sum is needed per chunk, to see
+// whether the chunk completes the fill.
+#if defined(__AVX2__)
+inline double horizontal_sum(__m256d v) {
+    __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+class ChunkSummer {
+public:
+    double sum(const double* p, int64_t first) {
+        const __m256d step = _mm256_set1_pd(8.0);
+        __m256d index0 = _mm256_add_pd(_mm256_set1_pd(static_cast<double>(first)), _mm256_set_pd(3.0, 2.0, 1.0, 0.0));
+        __m256d index1 = _mm256_add_pd(index0, _mm256_set1_pd(4.0));
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        __m256d w0 = _mm256_setzero_pd(), w1 = _mm256_setzero_pd();
+        for (int k = 0; k < kChunk; k += 8) {
+            __m256d v0 = _mm256_loadu_pd(p + k);
+            __m256d v1 = _mm256_loadu_pd(p + k + 4);
+            s0 = _mm256_add_pd(s0, v0);
+            s1 = _mm256_add_pd(s1, v1);
+            w0 = _mm256_add_pd(w0, _mm256_mul_pd(v0, index0));
+            w1 = _mm256_add_pd(w1, _mm256_mul_pd(v1, index1));
+            index0 = _mm256_add_pd(index0, step);
+            index1 = _mm256_add_pd(index1, step);
+        }
+        pending_ = _mm256_add_pd(w0, w1);
+        return horizontal_sum(_mm256_add_pd(s0, s1));
+    }
+    void accept() { weighted_ = _mm256_add_pd(weighted_, pending_); }
+    double weighted() const { return horizontal_sum(weighted_); }
+
+private:
+    __m256d pending_ = _mm256_setzero_pd();
+    __m256d weighted_ = _mm256_setzero_pd();
+};
+
+inline double sum_range(const double* p, int64_t n) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    __m256d s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+    int64_t k = 0;
+    for (; k + 16 <= n; k += 16) {
+        s0 = _mm256_add_pd(s0, _mm256_loadu_pd(p + k));
+        s1 = _mm256_add_pd(s1, _mm256_loadu_pd(p + k + 4));
+        s2 = _mm256_add_pd(s2, _mm256_loadu_pd(p + k + 8));
+        s3 = _mm256_add_pd(s3, _mm256_loadu_pd(p + k + 12));
+    }
+    double sum = horizontal_sum(_mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+    for (; k < n; ++k) sum += p[k];
+    return sum;
+}
+#elif defined(__SSE2__)
+inline double horizontal_sum(__m128d v) {
+    return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+}
+
+class ChunkSummer {
+public:
+    double sum(const double* p, int64_t first) {
+        const __m128d step = _mm_set1_pd(4.0);
+        __m128d index0 = _mm_add_pd(_mm_set1_pd(static_cast<double>(first)), _mm_set_pd(1.0, 0.0));
+        __m128d index1 = _mm_add_pd(index0, _mm_set1_pd(2.0));
+        __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+        __m128d w0 = _mm_setzero_pd(), w1 = _mm_setzero_pd();
+        for (int k = 0; k < kChunk; k += 4) {
+            __m128d v0 = _mm_loadu_pd(p + k);
+            __m128d v1 = _mm_loadu_pd(p + k + 2);
+            s0 = _mm_add_pd(s0, v0);
+            s1 = _mm_add_pd(s1, v1);
+            w0 = _mm_add_pd(w0, _mm_mul_pd(v0, index0));
+            w1 = _mm_add_pd(w1, _mm_mul_pd(v1, index1));
+            index0 = _mm_add_pd(index0, step);
+            index1 = _mm_add_pd(index1, step);
+        }
+        pending_ = _mm_add_pd(w0, w1);
+        return horizontal_sum(_mm_add_pd(s0, s1));
+    }
+    void accept() { weighted_ = _mm_add_pd(weighted_, pending_); }
+    double weighted() const { return horizontal_sum(weighted_); }
+
+private:
+    __m128d pending_ = _mm_setzero_pd();
+    __m128d weighted_ = _mm_setzero_pd();
+};
+
+inline double sum_range(const double* p, int64_t n) {
+    __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+    __m128d s2 = _mm_setzero_pd(), s3 = _mm_setzero_pd();
+    int64_t k = 0;
+    for (; k + 8 <= n; k += 8) {
+        s0 = _mm_add_pd(s0, _mm_loadu_pd(p + k));
+        s1 = _mm_add_pd(s1, _mm_loadu_pd(p + k + 2));
+        s2 = _mm_add_pd(s2, _mm_loadu_pd(p + k + 4));
+        s3 = _mm_add_pd(s3, _mm_loadu_pd(p + k + 6));
+    }
+    double sum = horizontal_sum(_mm_add_pd(_mm_add_pd(s0, s1), _mm_add_pd(s2, s3)));
+    for (; k < n; ++k) sum += p[k];
+    return sum;
+}
+#else
+class ChunkSummer {
+public:
+    double sum(const double* p, int64_t first) {
+        double sum = 0.0;
+        pending_ = 0.0;
+        for (int k = 0; k < kChunk; ++k) {
+            sum += p[k];
+            pending_ += p[k] * static_cast<double>(first + k);
+        }
+        return sum;
+    }
+    void accept() { weighted_ += pending_; }
+    double weighted() const { return weighted_; }
+
+private:
+    double pending_ = 0.0;
+    double weighted_ = 0.0;
+};
+
+inline double sum_range(const double* p, int64_t n) {
+    double sum = 0.0;
+    for (int64_t k = 0; k < n; ++k) sum += p[k];
+    return sum;
+}
+#endif
+
+}  // namespace
+
+PriceLadder::PriceLadder(Side side, size_t levels) : side_(side), amounts_(levels, 0.0) {}
+
+void PriceLadder::clear() {
+    std::fill(amounts_.begin(), amounts_.end(), 0.0);
+    best_ = -1;
+    best_amount_ = 0.0;
+    count_ = 0;
+    truncated_ = false;
+}
+
+void PriceLadder::set(Price price, double amount) {
+    int64_t tick = price.units;
+
+    int64_t index = tick - base_tick_;
+    if (static_cast<uint64_t>(index) >= amounts_.size() || (best_ < 0 && amount != 0.0)) {
+        if (amount == 0.0) {
+            return;  // nothing is stored outside the window
+        }
+        if (!cover(tick)) {
+            truncated_ = true;
+            return;
+        }
+        index = tick - base_tick_;
+    }
+
+    double& slot = amounts_[static_cast<size_t>(index)];
+    count_ += (slot == 0.0) & (amount != 0.0);
+    count_ -= (slot != 0.0) & (amount == 0.0);
+    slot = amount;
+
+    if (amount != 0.0) {
+        if (best_ < 0 || better(index, best_)) {
+            best_ = index;
+        }
+        if (index == best_) {
+            best_amount_ = amount;
+        }
+    } else if (index == best_) {
+        find_next_best();
+    }
+}
+
+void PriceLadder::find_next_best() {
+    int64_t step = side_ == Side::Bid ? -1 : 1;
+    for (int64_t i = best_ + step; i >= 0 && i < size(); i += step) {
+        if (amounts_[static_cast<size_t>(i)] != 0.0) {
+            best_ = i;
+            best_amount_ = amounts_[static_cast<size_t>(i)];
+            return;
+        }
+    }
+    best_ = -1;
+    best_amount_ = 0.0;
+}
+
+bool PriceLadder::cover(int64_t tick) {
+    int64_t n = size();
+    // Keep the best level near the middle; the side extends away from the
+    // spread, so leave more room on that side
+    auto preferred_base = [this](int64_t best_tick, int64_t levels) {
+        return side_ == Side::Bid ? best_tick - (3 * levels) / 4 : best_tick - levels / 4;
+    };
+    if (best_ < 0) {
+        base_tick_ = preferred_base(tick, n);  // every level is zero, nothing moves
+        return true;
+    }
+
+    // Every occupied level has to stay inside the new window
+    int64_t low = 0;
+    int64_t high = n - 1;
+    while (amounts_[static_cast<size_t>(low)] == 0.0) ++low;
+    while (amounts_[static_cast<size_t>(high)] == 0.0) --high;
+    int64_t first = std::min(base_tick_ + low, tick);
+    int64_t last = std::max(base_tick_ + high, tick);
+    int64_t span = last - first + 1;
+    if (span > n) {
+        if (span > kMaxLevels) {
+            return false;
+        }
+        // Doubling keeps reallocations rare; the old levels keep their index
+        while (n < span) n *= 2;
+        n = std::min(n, kMaxLevels);
+        amounts_.resize(static_cast<size_t>(n), 0.0);
+    }
+
+    int64_t best_tick = better(tick - base_tick_, best_) ? tick : base_tick_ + best_;
+    int64_t base = std::clamp(preferred_base(best_tick, n), last - n + 1, first);
+    shift(base - base_tick_);
+    return true;
+}
+
+void PriceLadder::shift(int64_t delta) {
+    // In place: the occupied levels fit both windows, so |delta| < size()
+    double* levels = amounts_.data();
+    int64_t n = size();
+    if (delta > 0) {
+        std::move(levels + delta, levels + n, levels);
+        std::fill(levels + n - delta, levels + n, 0.0);
+    } else if (delta < 0) {
+        std::move_backward(levels, levels + n + delta, levels + n);
+        std::fill(levels, levels - delta, 0.0);
+    }
+    base_tick_ += delta;
+    best_ -= delta;
+}
+
+SweepResult PriceLadder::sweep(double amount) const {
+    SweepResult result;
+    if (best_ < 0 || amount <= 0.0) {
+        return result;
+    }
+    const double* levels = amounts_.data();
+    int64_t n = size();
+    double filled = 0.0;
+    ChunkSummer chunks;
+
+    // ✅ Whole chunks while they cannot complete the fill, then level by
+    // level through the chunk that does
+    int64_t i = best_;
+    int64_t step = side_ == Side::Bid ? -1 : 1;
+    for (;;) {
+        int64_t first = side_ == Side::Bid ? i - kChunk + 1 : i;
+        if (first < 0 || first + kChunk > n) {
+            break;
+        }
+        double sum = chunks.sum(levels + first, first);
+        if (filled + sum >= amount) {
+            break;
+        }
+        filled += sum;
+        chunks.accept();
+        i += step * kChunk;
+    }
+
+    double weighted = chunks.weighted();  // sum of amount * index
+    int64_t last = -1;
+    for (; i >= 0 && i < n; i += step) {
+        double level = levels[static_cast<size_t>(i)];
+        if (level == 0.0) {
+            continue;
+        }
+        double take = std::min(level, amount - filled);
+        filled += take;
+        weighted += take * static_cast<double>(i);
+        last = i;
+        if (filled >= amount) {
+            break;
+        }
+    }
+    if (last < 0) {
+        // Ran out inside skipped chunks: the worst level is the deepest one
+        for (last = side_ == Side::Bid ? 0 : n - 1; levels[static_cast<size_t>(last)] == 0.0; last -= step) {
+        }
+    }
+
+    result.filled = filled;
+    result.tick_notional = weighted + static_cast<double>(base_tick_) * filled;
+    result.worst = price_at(last);
+    return result;
+}
+
+double PriceLadder::depth_within(int64_t ticks) const {
+    if (best_ < 0 || ticks < 0) {
+        return 0.0;
+    }
+    int64_t low = side_ == Side::Bid ? std::max<int64_t>(0, best_ - ticks) : best_;
+    int64_t high = side_ == Side::Bid ? best_ : std::min(size() - 1, best_ + ticks);
+    return sum_range(amounts_.data() + low, high - low + 1);
+}
@@ -0,0 +1,163 @@
+#include "../include/rate_limiter.h"
+#include "../include/json_index.h"
+#include <algorithm>
+
+RateLimiter::RateLimiter() : RateLimiter(kMatchingEngine, kNonMatchingEngine) {}
+
+RateLimiter::RateLimiter(Bucket matching_engine, Bucket non_matching_engine) {
+    Clock::time_point now = Clock::now();
+    pools_[0] = State{matching_engine, matching_engine.max_credits, now};
+    pools_[1] = State{non_matching_engine, non_matching_engine.max_credits, now};
+}
+
+void RateLimiter::refill(State& s, Clock::time_point now) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - s.updated).count();
+    int64_t earned = elapsed * s.bucket.refill_per_second / 1000000;
+    if (earned <= 0) {
+        return;
+    }
+    s.credits = std::min(s.bucket.max_credits, s.credits + earned);
+    // Advance only by the time actually converted, so fractions are not lost
+    s.updated += std::chrono::microseconds(earned * 1000000 / s.bucket.refill_per_second);
+    if (s.credits == s.bucket.max_credits) {
+        s.updated = now;
+    }
+}
+
+int64_t RateLimiter::required(const State& s, Priority priority) const {
+    return s.bucket.cost + (priority == Priority::Cancel ? 0 : s.bucket.cancel_reserve);
+}
+
+bool RateLimiter::outranked(const State& s, Priority priority) const {
+    for (int p = 0; p < static_cast<int>(priority); ++p) {
+        if (s.waiting[p] > 0) return true;
+    }
+    return false;
+}
+
+std::chrono::nanoseconds RateLimiter::time_to(const State& s, int64_t credits) const {
+    int64_t missing = credits - s.credits;
+    if (missing <= 0) {
+        return std::chrono::nanoseconds(0);
+    }
+    // Rounded up so the caller wakes with the credits already there
+    int64_t micros = (missing * 1000000 + s.bucket.refill_per_second - 1) / s.bucket.refill_per_second;
+    return std::chrono::microseconds(micros);
+}
+
+bool RateLimiter::try_acquire(Class request) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    State& s = state(request.pool);
+    refill(s, Clock::now());
+    if (outranked(s, request.priority) || s.credits < required(s, request.priority)) {
+        return false;
+    }
+    s.credits -= s.bucket.cost;
+    return true;
+}
+
+void RateLimiter::acquire(Class request) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    State& s = state(request.pool);
+    int& waiting = s.waiting[static_cast<int>(request.priority)];
+    ++waiting;
+    while (true) {
+        refill(s, Clock::now());
+        if (!outranked(s, request.priority) && s.credits >= required(s, request.priority)) {
+            break;
+        }
+        // Woken early when another waiter leaves, since that may unblock us
+        released_.wait_for(lock, time_to(s, required(s, request.priority)) + std::chrono::microseconds(100));
+    }
+    --waiting;
+    s.credits -= s.bucket.cost;
+    lock.unlock();
+    released_.notify_all();
+}
+
+void RateLimiter::add_waiter(Class request) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++state(request.pool).waiting[static_cast<int>(request.priority)];
+}
+
+bool RateLimiter::try_acquire_waiter(Class request) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        State& s = state(request.pool);
+        refill(s, Clock::now());
+        // Only higher priorities count; the waiter itself is at its own level
+        if (outranked(s, request.priority) || s.credits < required(s, request.priority)) {
+            return false;
+        }
+        --s.waiting[static_cast<int>(request.priority)];
+        s.credits -= s.bucket.cost;
+    }
+    released_.notify_all();
+    return true;
+}
+
+void RateLimiter::remove_waiter(Class request) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --state(request.pool).waiting[static_cast<int>(request.priority)];
+    }
+    released_.notify_all();
+}
+
+std::chrono::nanoseconds RateLimiter::wait_time(Class request) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    State& s = state(request.pool);
+    refill(s, Clock::now());
+    return time_to(s, required(s, request.priority));
+}
+
+void RateLimiter::on_rejected(Pool pool) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    State& s = state(pool);
+    s.credits = 0;
+    s.updated = Clock::now();
+}
+
+int64_t RateLimiter::credits(Pool pool) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    State& s = state(pool);
+    refill(s, Clock::now());
+    return s.credits;
+}
+
+RateLimiter::Class RateLimiter::classify(std::string_view method) {
+    static constexpr std::string_view kApiPrefix = "/api/v2/";
+    size_t prefix = method.find(kApiPrefix);
+    if (prefix != std::string_view::npos) {
+        method.remove_prefix(prefix + kApiPrefix.size());
+    }
+
+    auto starts_with = [&](std::string_view p) { return method.substr(0, p.size()) == p; };
+    if (starts_with("private/cancel")) {  // cancel, cancel_all*, cancel_by_label
+        return {Pool::MatchingEngine, Priority::Cancel};
+    }
+    if (starts_with("private/edit")) {  // edit, edit_by_label
+        return {Pool::MatchingEngine, Priority::Edit};
+    }
+    if (method == "private/buy" || method == "private/sell" || method == "private/close_position") {
+        return {Pool::MatchingEngine, Priority::Order};
+    }
+    return {Pool::NonMatchingEngine, Priority::Other};
+}
+
+bool RateLimiter::is_rate_limited(const json& response) {
+    auto error = response.find("error");
+    if (error == response.end() || !error->is_object()) {
+        return false;
+    }
+    auto code = error->find("code");
+    return code != error->end() && code->is_number_integer() && code->get<int64_t>() == 10028;
+}
+
+bool RateLimiter::is_rate_limited_raw(std::string_view response) {
+    if (response.find("10028") == std::string_view::npos) {
+        return false;
+    }
+    static thread_local JsonIndex index;
+    return index.build(response) && index.find({"error", "code"}) == "10028";
+}
@@ -0,0 +1,168 @@
+#include "../include/rpc_encoder.h"
+#include <charconv>
+#include <cstring>
+
+// Constant fragments of each request template
+static constexpr std::string_view kHead = "{\"jsonrpc\":\"2.0\",\"id\":";
+static constexpr std::string_view kBuyMethod = ",\"method\":\"private/buy\",\"params\":{";
+static constexpr std::string_view kSellMethod = ",\"method\":\"private/sell\",\"params\":{";
+static constexpr std::string_view kEditMethod = ",\"method\":\"private/edit\",\"params\":{";
+static constexpr std::string_view kCancelMethod = ",\"method\":\"private/cancel\",\"params\":{";
+static constexpr std::string_view kInstrument = "\"instrument_name\":\"";
+static constexpr std::string_view kOrderId = "\"order_id\":\"";
+static constexpr std::string_view kAmount = "\",\"amount\":";
+static constexpr std::string_view kType = ",\"type\":\"";
+static constexpr std::string_view kPrice = ",\"price\":";
+static constexpr std::string_view kTail = "}}";
+
+void RpcEncoder::put(std::string_view fragment) {
+    if (!ok_ || fragment.size() > kCapacity - pos_) {
+        ok_ = false;
+        return;
+    }
+    std::memcpy(buf_ + pos_, fragment.data(), fragment.size());
+    pos_ += fragment.size();
+}
+
+void RpcEncoder::put_string(std::string_view value) {
+    static const char hex[] = "0123456789abcdef";
+    for (char c : value) {
+        if (!ok_ || kCapacity - pos_ < 6) {
+            ok_ = false;
+            return;
+        }
+        unsigned char u = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            buf_[pos_++] = '\\';
+            buf_[pos_++] = c;
+        } else if (u < 0x20) {
+            buf_[pos_++] = '\\';
+            buf_[pos_++] = 'u';
+            buf_[pos_++] = '0';
+            buf_[pos_++] = '0';
+            buf_[pos_++] = hex[u >> 4];
+            buf_[pos_++] = hex[u & 0xF];
+        } else {
+            buf_[pos_++] = c;
+        }
+    }
+}
+
+void RpcEncoder::put_uint(uint64_t value) {
+    if (!ok_) return;
+    auto result = std::to_chars(buf_ + pos_, buf_ + kCapacity, value);
+    if (result.ec != std::errc()) {
+        ok_ = false;
+        return;
+    }
+    pos_ = static_cast<size_t>(result.ptr - buf_);
+}
+
+void RpcEncoder::put_int(int value) {
+    if (!ok_) return;
+    auto result = std::to_chars(buf_ + pos_, buf_ + kCapacity, value);
+    if (result.ec != std::errc()) {
+        ok_ = false;
+        return;
+    }
+    pos_ = static_cast<size_t>(result.ptr - buf_);
+}
+
+void RpcEncoder::put_double(double value) {
+    if (!ok_) return;
+    // Shortest representation that round-trips, same digits nlohmann would emit
+    auto result = std::to_chars(buf_ + pos_, buf_ + kCapacity, value);
+    if (result.ec != std::errc()) {
+        ok_ = false;
+        return;
+    }
+    pos_ = static_cast<size_t>(result.ptr - buf_);
+}
+
+void RpcEncoder::put_decimal(Decimal value) {
+    // format_decimal needs at most 24 chars
+    if (!ok_ || kCapacity - pos_ < 24) {
+        ok_ = false;
+        return;
+    }
+    pos_ += format_decimal(value, buf_ + pos_);
+}
+
+void RpcEncoder::begin(uint64_t id, std::string_view method_fragment) {
+    pos_ = 0;
+    ok_ = true;
+    put(kHead);
+    put_uint(id);
+    put(method_fragment);
+}
+
+std::string_view RpcEncoder::finish() {
+    put(kTail);
+    if (!ok_) {
+        return {};
+    }
+    return std::string_view(buf_, pos_);
+}
+
+template <typename Amount, typename Number>
+std::string_view RpcEncoder::order(std::string_view method_fragment, uint64_t id, std::string_view instrument,
+                                   Amount amount, std::string_view type, Number price) {
+    begin(id, method_fragment);
+    put(kInstrument);
+    put_string(instrument);
+    put(kAmount);
+    put_number(amount);
+    put(kType);
+    put_string(type);
+    put("\"");
+    // ✅ Only limit orders carry a price
+    if (type == "limit") {
+        put(kPrice);
+        put_number(price);
+    }
+    return finish();
+}
+
+template <typename Amount, typename Number>
+std::string_view RpcEncoder::edit_order(uint64_t id, std::string_view order_id, Amount amount, Number price) {
+    begin(id, kEditMethod);
+    put(kOrderId);
+    put_string(order_id);
+    put(kAmount);
+    put_number(amount);
+    put(kPrice);
+    put_number(price);
+    return finish();
+}
+
+std::string_view RpcEncoder::buy(uint64_t id, std::string_view instrument, int amount, std::string_view type, double price) {
+    return order(kBuyMethod, id, instrument, amount, type, price);
+}
+
+std::string_view RpcEncoder::sell(uint64_t id, std::string_view instrument, int amount, std::string_view type, double price) {
+    return order(kSellMethod, id, instrument, amount, type, price);
+}
+
+std::string_view RpcEncoder::edit(uint64_t id, std::string_view order_id, int amount, double price) {
+    return edit_order(id, order_id, amount, price);
+}
+
+std::string_view RpcEncoder::buy(uint64_t id, std::string_view instrument, Decimal amount, std::string_view type, Decimal price) {
+    return order(kBuyMethod, id, instrument, amount, type, price);
+}
+
+std::string_view RpcEncoder::sell(uint64_t id, std::string_view instrument, Decimal amount, std::string_view type, Decimal price) {
+    return order(kSellMethod, id, instrument, amount, type, price);
+}
+
+std::string_view RpcEncoder::edit(uint64_t id, std::string_view order_id, Decimal amount, Decimal price) {
+    return edit_order(id, order_id, amount, price);
+}
+
+std::string_view RpcEncoder::cancel(uint64_t id, std::string_view order_id) {
+    begin(id, kCancelMethod);
+    put(kOrderId);
+    put_string(order_id);
+    put("\"");
+    return finish();
+}
@@ -0,0 +1,59 @@
+#include "../include/schema_decoder.h"
+#include "../include/json_scanner.h"
+
+namespace {
+
+// JsonScanner handler that accepts a single string value
+struct StringValue {
+    std::string& out;
+
+    bool start_object() { return false; }
+    bool end_object() { return false; }
+    bool start_array() { return false; }
+    bool end_array() { return false; }
+    bool key(std::string_view) { return false; }
+    bool string(std::string_view value) { out.assign(value.data(), value.size()); return true; }
+    bool number(std::string_view, bool) { return false; }
+    bool boolean(bool) { return false; }
+    bool null() { return false; }
+};
+
+}  // namespace
+
+bool schema_detail::decode_string(std::string_view quoted, std::string& out) {
+    if (quoted.size() < 2) {
+        return false;
+    }
+    std::string_view raw = quoted.substr(1, quoted.size() - 2);
+    if (raw.find('\\') == std::string_view::npos) {
+        out.assign(raw.data(), raw.size());
+        return true;
+    }
+    // Escapes are rare in responses; let the scanner decode them
+    static thread_local JsonScanner scanner;
+    StringValue sink{out};
+    return scanner.parse(quoted, sink);
+}
+
+size_t locate_result(JsonIndex& index, std::string_view body, RpcError& error) {
+    error = RpcError{};
+    if (!index.build(body) || index.size() == 0) {
+        error.message = "Malformed response";
+        return index.size();
+    }
+    size_t result_at = index.size();
+    size_t error_at = index.size();
+    index.for_each_member(0, [&](std::string_view key, size_t value) {
+        if (key == "result") result_at = value;
+        else if (key == "error") error_at = value;
+        return true;
+    });
+    if (error_at != index.size()) {
+        decode(index, error_at, error);
+        return index.size();
+    }
+    if (result_at == index.size()) {
+        error.message = "Missing result";
+    }
+    return result_at;
+}
@@ -0,0 +1,131 @@
+#include "../include/sharded_feed.h"
+#include "../include/instrument_registry.h"
+#include "../include/low_latency.h"
+#include <algorithm>
+#include <exception>
+#include <future>
+
+ShardedFeed::ShardedFeed(size_t shards, std::vector<int> cpus) {
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    shards_.reserve(shards);
+    for (size_t i = 0; i < shards; ++i) {
+        auto shard = std::make_unique<Shard>();
+        shard->cpu = i < cpus.size() ? cpus[i] : static_cast<int>((i + 1) % cores);
+        shards_.push_back(std::move(shard));
+    }
+}
+
+ShardedFeed::~ShardedFeed() {
+    stop();
+}
+
+void ShardedFeed::connect(const std::string& host, const std::string& port, const std::string& path) {
+    std::vector<std::future<void>> connected;
+    for (auto& shard : shards_) {
+        auto ready = std::make_shared<std::promise<void>>();
+        connected.push_back(ready->get_future());
+        Shard* s = shard.get();
+        // Handshakes run in parallel, each on the thread that will own the socket
+        s->thread = std::thread([s, ready, host, port, path, spin = spin_] {
+            pin_current_thread({s->cpu});
+            try {
+                s->client.connect(host, port, path);
+                ready->set_value();
+            } catch (...) {
+                ready->set_exception(std::current_exception());
+                return;
+            }
+            if (spin) {
+                run_spinning(s->ioc);
+            } else {
+                s->ioc.run();
+            }
+        });
+    }
+    for (auto& result : connected) {
+        result.get();
+    }
+}
+
+void ShardedFeed::enable_spin_mode(std::chrono::microseconds busy_poll) {
+    spin_ = true;
+    for (auto& shard : shards_) {
+        shard->client.set_busy_poll(busy_poll);
+    }
+}
+
+size_t ShardedFeed::shard_of(std::string_view instrument) const {
+    // FNV-1a: unlike std::hash, the same name maps to the same shard in every build
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : instrument) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return static_cast<size_t>(hash % shards_.size());
+}
+
+size_t ShardedFeed::fastest_shard() const {
+    size_t best = 0;
+    std::chrono::nanoseconds best_rtt = std::chrono::nanoseconds::max();
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        const LatencyHistogram& latency = shards_[i]->client.latency();
+        if (latency.count() > 0 && latency.percentile(50) < best_rtt) {
+            best_rtt = latency.percentile(50);
+            best = i;
+        }
+    }
+    return best;
+}
+
+std::string_view ShardedFeed::instrument_of(std::string_view channel) {
+    return InstrumentRegistry::instrument_of(channel);
+}
+
+std::vector<std::vector<std::string>> ShardedFeed::split(const std::vector<std::string>& channels) const {
+    std::vector<std::vector<std::string>> by_shard(shards_.size());
+    for (const auto& channel : channels) {
+        std::string_view instrument = instrument_of(channel);
+        by_shard[shard_of(instrument.empty() ? std::string_view(channel) : instrument)].push_back(channel);
+    }
+    return by_shard;
+}
+
+void ShardedFeed::subscribe(const std::vector<std::string>& channels, ChannelHandler handler) {
+    auto by_shard = split(channels);
+    for (size_t i = 0; i < by_shard.size(); ++i) {
+        if (!by_shard[i].empty()) {
+            shards_[i]->client.subscribe(by_shard[i], handler);
+        }
+    }
+}
+
+void ShardedFeed::subscribe_events(const std::vector<std::string>& channels, EventHandler handler) {
+    auto by_shard = split(channels);
+    for (size_t i = 0; i < by_shard.size(); ++i) {
+        if (!by_shard[i].empty()) {
+            shards_[i]->client.subscribe_events(by_shard[i], handler);
+        }
+    }
+}
+
+void ShardedFeed::unsubscribe(const std::vector<std::string>& channels) {
+    auto by_shard = split(channels);
+    for (size_t i = 0; i < by_shard.size(); ++i) {
+        if (!by_shard[i].empty()) {
+            shards_[i]->client.unsubscribe(by_shard[i]);
+        }
+    }
+}
+
+void ShardedFeed::stop() {
+    for (auto& shard : shards_) {
+        if (!shard->thread.joinable()) {
+            continue;
+        }
+        // Closing the socket ends the read loop; run() returns once the
+        // remaining handlers have drained
+        shard->client.close();
+        shard->work.reset();
+        shard->thread.join();
+    }
+}
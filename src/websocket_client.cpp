@@ -1,65 +1,540 @@
+#include "../include/websocket_client.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
 #include <iostream>
-#include <boost/asio.hpp>
-#include <boost/beast/core.hpp>
-#include <boost/beast/websocket.hpp>
-#include "../include/json.hpp"
-
-using namespace boost::asio;
-using namespace boost::beast;
-using json = nlohmann::json;
-
-class WebSocketClient {
-public:
-    WebSocketClient(io_context& ioc) : resolver_(ioc), ws_(ioc) {}
-
-    void connect(const std::string& host, const std::string& port, const std::string& path) {
-        auto results = resolver_.resolve(host, port);
-        boost::asio::connect(ws_.next_layer(), results.begin(), results.end());
-        ws_.handshake(host, path);
-        std::cout << "✅ Connected to Deribit WebSocket!" << std::endl;
-    }
-
-    void subscribe_order_book(const std::string& instrument) {
-        json request = {
-            {"jsonrpc", "2.0"},
-            {"id", 1},
-            {"method", "public/subscribe"},
-            {"params", {
-                {"channels", {"book." + instrument + ".100ms"}}
-            }}
-        };
-
-        ws_.write(boost::asio::buffer(request.dump()));
-        std::cout << "📡 Subscribed to Order Book for " << instrument << std::endl;
-        listen();
-    }
-
-    void subscribe_order_updates() {
-        json request = {
-            {"jsonrpc", "2.0"},
-            {"id", 2},
-            {"method", "private/subscribe"},
-            {"params", {
-                {"channels", {"user.orders.BTC-PERPETUAL.raw"}}
-            }}
-        };
-
-        ws_.write(boost::asio::buffer(request.dump()));
-        std::cout << "📡 Subscribed to Order Updates!" << std::endl;
-        listen();
-    }
-
-private:
-    ip::tcp::resolver resolver_;
-    websocket::stream<ip::tcp::socket> ws_;
-
-    void listen() {
-        while (true) {
-            flat_buffer buffer;
-            ws_.read(buffer);
-            std::string response = boost::beast::buffers_to_string(buffer.data());
-            json parsed = json::parse(response);
-            std::cout << "🔹 Update: " << parsed.dump(4) << std::endl;
-        }
-    }
-};
+#include <sys/socket.h>
+
+namespace {
+
+std::string public_test_request(uint64_t id) {
+    return "{\"jsonrpc\":\"2.0\",\"id\":" + std::to_string(id) + ",\"method\":\"public/test\",\"params\":{}}";
+}
+
+// The id the decoder tags this channel's notifications with
+InstrumentId route_id(std::string_view channel) {
+    if (!FeedDecoder::carries_instrument(channel)) {
+        return kNoInstrument;
+    }
+    std::string_view instrument = InstrumentRegistry::instrument_of(channel);
+    return instrument.empty() ? kNoInstrument : InstrumentRegistry::instance().find(instrument);
+}
+
+}  // namespace
+
+WebSocketClient::WebSocketClient(io_context& ioc)
+    : ioc_(ioc), resolver_(ioc), reconnect_timer_(ioc), watchdog_timer_(ioc), probe_timer_(ioc) {}
+
+void WebSocketClient::connect(const std::string& host, const std::string& port, const std::string& path) {
+    auto endpoints = resolver_.resolve(host, port);
+    websocket::stream<ip::tcp::socket> stream(ioc_);
+    boost::asio::connect(stream.next_layer(), endpoints.begin(), endpoints.end());
+    configure_socket(stream.next_layer());
+    stream.handshake(host, path);
+    stream.text(true);
+    std::cout << "✅ Connected to Deribit WebSocket!" << std::endl;
+
+    // Everything the read loop touches belongs to the io_context thread
+    post(ioc_, [this, stream = std::move(stream), endpoints, host, port, path]() mutable {
+        host_ = host;
+        port_ = port;
+        path_ = path;
+        endpoints_ = endpoints;
+        ws_.emplace(std::move(stream));
+        on_connected(false);
+    });
+}
+
+void WebSocketClient::configure_socket(ip::tcp::socket& socket) {
+    socket.set_option(ip::tcp::no_delay(true));
+#ifdef SO_BUSY_POLL
+    if (busy_poll_.count() > 0) {
+        int budget = static_cast<int>(busy_poll_.count());
+        if (::setsockopt(socket.native_handle(), SOL_SOCKET, SO_BUSY_POLL, &budget, sizeof(budget)) != 0) {
+            std::cerr << "⚠️ SO_BUSY_POLL not applied: " << std::strerror(errno) << std::endl;
+        }
+    }
+#endif
+}
+
+uint64_t WebSocketClient::add_connection_handler(ConnectionHandler handler) {
+    std::lock_guard<std::recursive_mutex> lock(connection_mutex_);
+    uint64_t id = next_handler_id_++;
+    connection_handlers_.emplace(id, std::move(handler));
+    return id;
+}
+
+void WebSocketClient::remove_connection_handler(uint64_t id) {
+    std::lock_guard<std::recursive_mutex> lock(connection_mutex_);
+    connection_handlers_.erase(id);
+}
+
+void WebSocketClient::send_subscribe(const char* method, const std::vector<std::string>& channels) {
+    json request = {
+        {"jsonrpc", "2.0"},
+        {"id", next_request_id()},
+        {"method", method},
+        {"params", {
+            {"channels", channels}
+        }}
+    };
+    send(request.dump());
+}
+
+void WebSocketClient::subscribe(const std::vector<std::string>& channels, ChannelHandler handler) {
+    // Ids exist before the first notification, so the decoder can tag it.
+    // One intern call: the registry rebuilds its hash once per call.
+    std::vector<std::string> instruments;
+    for (const auto& channel : channels) {
+        std::string_view instrument = InstrumentRegistry::instrument_of(channel);
+        if (FeedDecoder::carries_instrument(channel) && !instrument.empty()) {
+            instruments.emplace_back(instrument);
+        }
+    }
+    if (!instruments.empty()) {
+        InstrumentRegistry::instance().intern(instruments);
+    }
+    post(ioc_, [this, channels, handler = std::move(handler)] {
+        std::vector<std::string> public_channels;
+        std::vector<std::string> private_channels;
+        for (const auto& channel : channels) {
+            add_route(*channels_.insert_or_assign(channel, handler).first);
+            (channel.rfind("user.", 0) == 0 ? private_channels : public_channels).push_back(channel);
+        }
+        // While disconnected the resubscription after the handshake covers them
+        if (!connected_) {
+            return;
+        }
+        if (!public_channels.empty()) {
+            send_subscribe("public/subscribe", public_channels);
+        }
+        if (!private_channels.empty()) {
+            send_subscribe("private/subscribe", private_channels);
+        }
+    });
+}
+
+void WebSocketClient::subscribe_events(const std::vector<std::string>& channels, EventHandler handler) {
+    subscribe(channels, [this, handler = std::move(handler)](const Notification& notification) {
+        events_.clear();
+        encode_events(notification, events_);
+        handler(events_);
+    });
+}
+
+void WebSocketClient::unsubscribe(const std::vector<std::string>& channels) {
+    post(ioc_, [this, channels] {
+        std::vector<std::string> public_channels;
+        std::vector<std::string> private_channels;
+        for (const auto& channel : channels) {
+            auto it = channels_.find(channel);
+            if (it != channels_.end()) {
+                remove_route(*it);
+                channels_.erase(it);
+            }
+            (channel.rfind("user.", 0) == 0 ? private_channels : public_channels).push_back(channel);
+        }
+        if (!connected_) {
+            return;
+        }
+        if (!public_channels.empty()) {
+            send_subscribe("public/unsubscribe", public_channels);
+        }
+        if (!private_channels.empty()) {
+            send_subscribe("private/unsubscribe", private_channels);
+        }
+    });
+}
+
+void WebSocketClient::add_route(const ChannelMap::value_type& entry) {
+    InstrumentId id = route_id(entry.first);
+    if (id == kNoInstrument) {
+        return;
+    }
+    auto& routes = routes_.emplace(id);
+    // Map nodes keep their address, so a resubscribed channel is listed already
+    if (std::find(routes.begin(), routes.end(), &entry) == routes.end()) {
+        routes.push_back(&entry);
+    }
+}
+
+void WebSocketClient::remove_route(const ChannelMap::value_type& entry) {
+    InstrumentId id = route_id(entry.first);
+    auto* routes = routes_.find(id);
+    if (!routes) {
+        return;
+    }
+    routes->erase(std::remove(routes->begin(), routes->end(), &entry), routes->end());
+    if (routes->empty()) {
+        routes_.erase(id);
+    }
+}
+
+const WebSocketClient::ChannelHandler* WebSocketClient::route(const Notification& notification) const {
+    if (notification.instrument != kNoInstrument) {
+        if (const auto* routes = routes_.find(notification.instrument)) {
+            for (const ChannelMap::value_type* entry : *routes) {
+                if (entry->first == notification.channel) {
+                    return &entry->second;
+                }
+            }
+        }
+        return nullptr;
+    }
+    // Channels by kind and currency, and untyped ones
+    auto it = channels_.find(notification.channel);
+    return it != channels_.end() ? &it->second : nullptr;
+}
+
+void WebSocketClient::resubscribe_all() {
+    std::vector<std::string> public_channels;
+    std::vector<std::string> private_channels;
+    for (const auto& entry : channels_) {
+        (entry.first.rfind("user.", 0) == 0 ? private_channels : public_channels).push_back(entry.first);
+    }
+    if (!public_channels.empty()) {
+        send_subscribe("public/subscribe", public_channels);
+    }
+    if (!private_channels.empty()) {
+        send_subscribe("private/subscribe", private_channels);
+    }
+}
+
+void WebSocketClient::subscribe_order_book(const std::string& instrument) {
+    subscribe_order_book(BookSubscription::incremental(instrument, BookSubscription::Interval::Ms100));
+}
+
+void WebSocketClient::subscribe_order_book(InstrumentId instrument) {
+    subscribe_order_book(InstrumentRegistry::instance().name(instrument));
+}
+
+void WebSocketClient::subscribe_order_book(const BookSubscription& spec) {
+    if (!spec.is_valid()) {
+        std::cerr << "❌ Unsupported order book subscription: " << spec.channel() << std::endl;
+        return;
+    }
+    subscribe({spec.channel()}, [](const Notification& update) {
+        std::cout << "🔹 Update: " << update.raw << std::endl;
+    });
+    std::cout << "📡 Subscribed to Order Book " << spec.channel() << std::endl;
+}
+
+void WebSocketClient::subscribe_order_updates(const std::string& instrument) {
+    subscribe({"user.orders." + instrument + ".raw"}, [](const Notification& update) {
+        std::cout << "🔹 Update: " << update.raw << std::endl;
+    });
+    std::cout << "📡 Subscribed to Order Updates!" << std::endl;
+}
+
+void WebSocketClient::send(std::string_view message) {
+    // dispatch, not post: from a handler the frame is queued in call order
+    boost::asio::dispatch(ioc_, [this, frame = std::string(message)]() mutable { enqueue(std::move(frame)); });
+}
+
+void WebSocketClient::enqueue(std::string frame) {
+    write_queue_.push_back(std::move(frame));
+    // A write is already running (on_write picks this frame up), or we are
+    // disconnected and the frame waits for the next session
+    if (connected_ && !writing_) {
+        do_write();
+    }
+}
+
+void WebSocketClient::set_message_handler(MessageHandler handler) {
+    post(ioc_, [this, handler = std::move(handler)] { handler_ = handler; });
+}
+
+void WebSocketClient::close() {
+    post(ioc_, [this] {
+        closing_ = true;
+        reconnect_timer_.cancel();
+        watchdog_timer_.cancel();
+        probe_timer_.cancel();
+        resolver_.cancel();
+        if (ws_) {
+            error_code ec;
+            ws_->next_layer().shutdown(ip::tcp::socket::shutdown_both, ec);
+            ws_->next_layer().close(ec);
+        }
+    });
+}
+
+void WebSocketClient::do_write() {
+    writing_ = true;
+    ws_->async_write(boost::asio::buffer(write_queue_.front()),
+                     [this, session = session_](error_code ec, std::size_t bytes) { on_write(session, ec, bytes); });
+}
+
+void WebSocketClient::on_write(uint64_t session, error_code ec, std::size_t) {
+    if (session != session_) {
+        retired_queues_.pop_front();
+        return;
+    }
+    writing_ = false;
+    if (ec) {
+        std::cerr << "❌ WebSocket write failed: " << ec.message() << std::endl;
+        on_connection_lost(ec);
+        return;
+    }
+    write_queue_.pop_front();
+    if (!write_queue_.empty()) {
+        do_write();
+    }
+}
+
+void WebSocketClient::do_read() {
+    ws_->async_read(read_buffer_,
+                    [this, session = session_](error_code ec, std::size_t bytes) { on_read(session, ec, bytes); });
+}
+
+void WebSocketClient::on_read(uint64_t session, error_code ec, std::size_t) {
+    if (session != session_) {
+        return;
+    }
+    if (ec) {
+        std::cerr << "❌ WebSocket read failed: " << ec.message() << std::endl;
+        on_connection_lost(ec);
+        return;
+    }
+
+    if (heartbeat_interval_.count() > 0) {
+        last_received_ = std::chrono::steady_clock::now();
+    }
+
+    // ✅ Decoded in place: flat_buffer keeps a frame contiguous, so no copy
+    auto data = read_buffer_.data();
+    dispatch(std::string_view(static_cast<const char*>(data.data()), data.size()));
+    read_buffer_.consume(read_buffer_.size());
+
+    do_read();
+}
+
+void WebSocketClient::dispatch(std::string_view message) {
+    // ✅ Subscription notification: decoded without a json DOM, routed by instrument id
+    if (decoder_.decode(message, notification_)) {
+        if (const ChannelHandler* handler = route(notification_)) {
+            (*handler)(notification_);
+        }
+        return;
+    }
+
+    if (handle_control(message)) {
+        return;
+    }
+    if (handler_) {
+        handler_(message);
+    }
+}
+
+bool WebSocketClient::handle_control(std::string_view message) {
+    // Nothing to look for unless heartbeats or a probe are active
+    if (heartbeat_interval_.count() == 0 && probe_id_ == 0) {
+        return false;
+    }
+    if (!control_index_.build(message)) {
+        return false;
+    }
+    if (control_index_.find_string({"method"}) == "heartbeat") {
+        // ✅ Deribit closes the session if a test_request goes unanswered
+        if (control_index_.find_string({"params", "type"}) == "test_request") {
+            send(public_test_request(next_request_id()));
+        }
+        return true;
+    }
+    uint64_t id = 0;
+    std::string_view id_text = control_index_.find({"id"});
+    std::from_chars(id_text.data(), id_text.data() + id_text.size(), id);
+    if (probe_id_ != 0 && id == probe_id_) {
+        latency_.record(std::chrono::steady_clock::now() - probe_sent_);
+        probe_id_ = 0;
+        return true;
+    }
+    return false;
+}
+
+void WebSocketClient::enable_heartbeat(std::chrono::seconds interval) {
+    post(ioc_, [this, interval] {
+        bool running = heartbeat_interval_.count() > 0;
+        heartbeat_interval_ = std::max(interval, std::chrono::seconds(10));
+        last_received_ = std::chrono::steady_clock::now();
+        if (connected_) {
+            send_heartbeat_request();
+        }
+        if (!running) {
+            schedule_watchdog();
+        }
+    });
+}
+
+void WebSocketClient::send_heartbeat_request() {
+    json request = {
+        {"jsonrpc", "2.0"},
+        {"id", next_request_id()},
+        {"method", "public/set_heartbeat"},
+        {"params", {
+            {"interval", heartbeat_interval_.count()}
+        }}
+    };
+    send(request.dump());
+}
+
+void WebSocketClient::schedule_watchdog() {
+    watchdog_timer_.expires_after(heartbeat_interval_);
+    watchdog_timer_.async_wait([this](error_code ec) {
+        if (ec || closing_) {
+            return;
+        }
+        // Heartbeats arrive every interval, so two silent intervals mean the
+        // peer is gone even though the socket still looks open
+        auto silent = std::chrono::steady_clock::now() - last_received_;
+        if (connected_ && silent > 2 * heartbeat_interval_) {
+            std::cerr << "❌ No traffic for "
+                      << std::chrono::duration_cast<std::chrono::seconds>(silent).count()
+                      << "s, dropping half-open connection" << std::endl;
+            on_connection_lost(boost::asio::error::timed_out);
+        }
+        schedule_watchdog();
+    });
+}
+
+void WebSocketClient::start_latency_probe(std::chrono::milliseconds period) {
+    post(ioc_, [this, period] {
+        bool running = probe_period_.count() > 0;
+        probe_period_ = period;
+        if (!running) {
+            schedule_probe();
+        }
+    });
+}
+
+void WebSocketClient::schedule_probe() {
+    probe_timer_.expires_after(probe_period_);
+    probe_timer_.async_wait([this](error_code ec) {
+        if (ec || closing_) {
+            return;
+        }
+        if (connected_) {
+            probe_id_ = next_request_id();
+            probe_sent_ = std::chrono::steady_clock::now();
+            send(public_test_request(probe_id_));
+        }
+        schedule_probe();
+    });
+}
+
+void WebSocketClient::notify(ConnectionEvent event) {
+    std::lock_guard<std::recursive_mutex> lock(connection_mutex_);
+    // By id rather than by iterator: a handler may add or remove handlers
+    for (auto it = connection_handlers_.begin(); it != connection_handlers_.end();) {
+        uint64_t id = it->first;
+        ConnectionHandler handler = it->second;  // outlives its own removal
+        handler(event);
+        it = connection_handlers_.upper_bound(id);
+    }
+}
+
+void WebSocketClient::on_connection_lost(error_code) {
+    if (closing_ || !connected_) {
+        return;
+    }
+    connected_ = false;
+    ++session_;  // completions still pending on the old socket become no-ops
+
+    // Frames of the lost session are dropped: whether they reached the
+    // server is unknown, and replaying an order could duplicate it
+    if (writing_) {
+        retired_queues_.push_back(std::move(write_queue_));
+        writing_ = false;
+    }
+    write_queue_.clear();
+
+    error_code ignored;
+    ws_->next_layer().close(ignored);
+
+    notify(ConnectionEvent::Disconnected);
+    schedule_reconnect();
+}
+
+void WebSocketClient::schedule_reconnect() {
+    std::chrono::milliseconds delay = backoff_;
+    backoff_ = backoff_.count() == 0 ? std::chrono::milliseconds(50)
+                                     : std::min(backoff_ * 2, std::chrono::milliseconds(5000));
+    reconnect_timer_.expires_after(delay);
+    reconnect_timer_.async_wait([this](error_code ec) {
+        if (!ec && !closing_) {
+            reconnect();
+        }
+    });
+}
+
+void WebSocketClient::reconnect() {
+    if (endpoints_.empty()) {
+        resolver_.async_resolve(host_, port_, [this](error_code ec, ip::tcp::resolver::results_type results) {
+            if (closing_) return;
+            if (ec) {
+                on_reconnect_failed(ec);
+                return;
+            }
+            endpoints_ = results;
+            reconnect();
+        });
+        return;
+    }
+
+    ws_.emplace(ioc_);
+    boost::asio::async_connect(ws_->next_layer(), endpoints_, [this](error_code ec, const ip::tcp::endpoint&) {
+        if (closing_) return;
+        if (ec) {
+            endpoints_ = {};  // the address may have moved: resolve again next time
+            on_reconnect_failed(ec);
+            return;
+        }
+        configure_socket(ws_->next_layer());
+        ws_->async_handshake(host_, path_, [this](error_code ec) {
+            if (closing_) return;
+            if (ec) {
+                on_reconnect_failed(ec);
+                return;
+            }
+            ws_->text(true);
+            std::cout << "✅ Reconnected to Deribit WebSocket!" << std::endl;
+            on_connected(true);
+        });
+    });
+}
+
+void WebSocketClient::on_reconnect_failed(error_code ec) {
+    std::cerr << "❌ WebSocket reconnect failed: " << ec.message() << ", retrying in "
+              << backoff_.count() << "ms" << std::endl;
+    schedule_reconnect();
+}
+
+void WebSocketClient::on_connected(bool reconnected) {
+    ++session_;
+    connected_ = true;
+    backoff_ = std::chrono::milliseconds(0);
+    read_buffer_.consume(read_buffer_.size());
+
+    // Order on the new socket: whatever the handlers send (public/auth),
+    // one batched resubscription, then frames sent while we were down
+    std::deque<std::string> backlog;
+    backlog.swap(write_queue_);
+    if (reconnected) {
+        notify(ConnectionEvent::Reconnected);
+    }
+    last_received_ = std::chrono::steady_clock::now();
+    probe_id_ = 0;  // an answer can no longer come on this socket
+    if (heartbeat_interval_.count() > 0) {
+        send_heartbeat_request();
+    }
+    resubscribe_all();
+    for (auto& frame : backlog) {
+        write_queue_.push_back(std::move(frame));
+    }
+
+    do_read();
+    if (!writing_ && !write_queue_.empty()) {
+        do_write();
+    }
+}
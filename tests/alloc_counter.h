@@ -0,0 +1,10 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <cstddef>
+
+// Tests linking alloc_counter.cpp replace the global operator new/delete
+// with versions that count every allocation in the process.
+size_t allocation_count();
+
+#endif
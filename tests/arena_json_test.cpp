@@ -0,0 +1,77 @@
+#include "../include/arena_json.h"
+#include <string>
+#include "alloc_counter.h"
+#include "test_util.h"
+
+// ArenaJson trees built inside a ResponseArena::Scope take their nodes and
+// strings from the arena. Global operator new is counted to show it: only
+// the parser's own depth-sized stacks still reach the heap.
+
+namespace {
+
+// A get_positions-like response with 'count' entries
+std::string positions_response(int count) {
+    std::string body = R"({"jsonrpc":"2.0","id":5,"result":[)";
+    for (int i = 0; i < count; ++i) {
+        if (i > 0) body += ',';
+        body += R"({"instrument_name":"BTC-27DEC24-)" + std::to_string(20000 + 1000 * i) +
+                R"(-C","direction":"buy","size":10.5,"average_price":0.0125,"kind":"option"})";
+    }
+    body += R"(],"usIn":1,"usOut":2,"usDiff":1,"testnet":true})";
+    return body;
+}
+
+size_t arena_parse_allocations(ResponseArena& arena, const std::string& body, ArenaJson& out) {
+    out = ArenaJson();
+    arena.reset();
+    size_t before = allocation_count();
+    {
+        ResponseArena::Scope scope(arena);
+        out = ArenaJson::parse(body);
+    }
+    return allocation_count() - before;
+}
+
+void test_tree_comes_from_the_arena() {
+    ResponseArena arena(1 << 20);
+    ArenaJson tree;
+    std::string small = positions_response(2);
+    std::string large = positions_response(200);
+
+    size_t small_count = arena_parse_allocations(arena, small, tree);
+    size_t large_count = arena_parse_allocations(arena, large, tree);
+    CHECK(tree["result"].size() == 200);
+    CHECK(tree["result"][199]["instrument_name"] == "BTC-27DEC24-219000-C");
+    // A hundred times the nodes, no more heap calls
+    CHECK(large_count == small_count);
+
+    size_t before = allocation_count();
+    nlohmann::json heap = nlohmann::json::parse(large);
+    size_t heap_count = allocation_count() - before;
+    CHECK(heap["result"].size() == 200);
+    CHECK(heap_count > 100 * (large_count + 1));
+    if (large_count != small_count || heap_count <= 100 * (large_count + 1)) {
+        std::cerr << "arena parse: " << small_count << " / " << large_count << " heap calls, json: " << heap_count
+                  << "\n";
+    }
+
+    // Reset and reuse: the same result again
+    arena_parse_allocations(arena, large, tree);
+    CHECK(tree["result"][0]["size"] == 10.5);
+    tree = ArenaJson();
+}
+
+void test_outside_a_scope_uses_the_heap() {
+    size_t before = allocation_count();
+    ArenaJson value = ArenaJson::parse(R"({"error":{"code":10009,"message":"not_enough_funds"}})");
+    CHECK(allocation_count() > before);
+    CHECK(value["error"]["message"] == "not_enough_funds");
+}
+
+}  // namespace
+
+int main() {
+    test_tree_comes_from_the_arena();
+    test_outside_a_scope_uses_the_heap();
+    return test_result();
+}
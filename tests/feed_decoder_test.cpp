@@ -0,0 +1,183 @@
+#include "../include/feed_decoder.h"
+#include <string>
+#include "test_util.h"
+
+namespace {
+
+// The same notification with "channel" before "data" (as Deribit sends it)
+// and with the keys reversed, "method" last
+std::string channel_first(const std::string& channel, const std::string& data) {
+    return R"({"jsonrpc":"2.0","method":"subscription","params":{"channel":")" + channel + R"(","data":)" + data + "}}";
+}
+
+std::string data_first(const std::string& channel, const std::string& data) {
+    return R"({"params":{"data":)" + data + R"(,"channel":")" + channel + R"("},"jsonrpc":"2.0","method":"subscription"})";
+}
+
+const char* kBookChange =
+    R"({"type":"change","timestamp":1700000000123,"prev_change_id":68870123,"instrument_name":"BTC-PERPETUAL",)"
+    R"("change_id":68870124,"bids":[["change",36950.5,12340.0],["delete",36949.0,0.0]],"asks":[["new",36951.0,20.0]]})";
+
+const char* kTrades =
+    R"([{"trade_seq":30289432,"trade_id":"48079254","timestamp":1590484156350,"price":8950.0,)"
+    R"("instrument_name":"BTC-PERPETUAL","direction":"sell","amount":10.0},)"
+    R"({"trade_seq":30289433,"trade_id":"48079255","timestamp":1590484156351,"price":8950.5,)"
+    R"("instrument_name":"BTC-PERPETUAL","direction":"buy","amount":20.0}])";
+
+const char* kTicker =
+    R"({"timestamp":1623060194301,"stats":{"volume":2,"low":1,"high":2},"mark_price":36922.42,"last_price":36923.5,)"
+    R"("instrument_name":"BTC-PERPETUAL","index_price":36919.07,"best_bid_price":36923.0,"best_bid_amount":4800.0,)"
+    R"("best_ask_price":36923.5,"best_ask_amount":320.0})";
+
+const char* kOrder =
+    R"({"price":36900.0,"order_type":"limit","order_state":"open","order_id":"5290947693","last_update_timestamp":1623060194301,)"
+    R"("instrument_name":"BTC-PERPETUAL","filled_amount":1.0,"direction":"buy","average_price":36899.5,"amount":10.0})";
+
+void test_book_key_order() {
+    FeedDecoder decoder;
+    for (bool reversed : {false, true}) {
+        Notification n;
+        std::string frame = reversed ? data_first("book.BTC-PERPETUAL.raw", kBookChange)
+                                     : channel_first("book.BTC-PERPETUAL.raw", kBookChange);
+        CHECK(decoder.decode(frame, n));
+        CHECK(n.kind == Notification::Kind::Book);
+        CHECK(n.channel == "book.BTC-PERPETUAL.raw");
+        CHECK(n.book.instrument == "BTC-PERPETUAL");
+        CHECK(!n.book.snapshot);
+        CHECK(n.book.change_id == 68870124);
+        CHECK(n.book.prev_change_id == 68870123);
+        CHECK(n.book.timestamp == 1700000000123);
+        CHECK(n.book.bids.size() == 2 && n.book.asks.size() == 1);
+        if (n.book.bids.size() == 2) {
+            CHECK(n.book.bids[0].action == BookLevelUpdate::Action::Change);
+            CHECK(to_double(n.book.bids[0].price) == 36950.5);
+            CHECK(n.book.bids[1].action == BookLevelUpdate::Action::Delete);
+        }
+    }
+}
+
+void test_trades_key_order() {
+    FeedDecoder decoder;
+    for (bool reversed : {false, true}) {
+        Notification n;
+        std::string frame = reversed ? data_first("trades.BTC-PERPETUAL.raw", kTrades)
+                                     : channel_first("trades.BTC-PERPETUAL.raw", kTrades);
+        CHECK(decoder.decode(frame, n));
+        CHECK(n.kind == Notification::Kind::Trades);
+        CHECK(n.trade_count == 2);
+        if (n.trade_count == 2) {
+            CHECK(n.trades[0].trade_id == "48079254" && !n.trades[0].buy);
+            CHECK(n.trades[1].trade_seq == 30289433);
+            CHECK(n.trades[1].price == 8950.5 && n.trades[1].amount == 20.0 && n.trades[1].buy);
+        }
+    }
+}
+
+void test_ticker_key_order() {
+    FeedDecoder decoder;
+    for (bool reversed : {false, true}) {
+        Notification n;
+        std::string frame = reversed ? data_first("ticker.BTC-PERPETUAL.raw", kTicker)
+                                     : channel_first("ticker.BTC-PERPETUAL.raw", kTicker);
+        CHECK(decoder.decode(frame, n));
+        CHECK(n.kind == Notification::Kind::Ticker);
+        CHECK(n.ticker.instrument == "BTC-PERPETUAL");
+        CHECK(n.ticker.best_bid_price == 36923.0 && n.ticker.best_ask_amount == 320.0);
+        CHECK(n.ticker.mark_price == 36922.42 && n.ticker.timestamp == 1623060194301);
+    }
+}
+
+void test_user_orders_key_order() {
+    FeedDecoder decoder;
+    for (bool reversed : {false, true}) {
+        Notification n;
+        std::string frame = reversed ? data_first("user.orders.BTC-PERPETUAL.raw", kOrder)
+                                     : channel_first("user.orders.BTC-PERPETUAL.raw", kOrder);
+        CHECK(decoder.decode(frame, n));
+        CHECK(n.kind == Notification::Kind::UserOrders);
+        CHECK(n.order_count == 1);
+        if (n.order_count == 1) {
+            CHECK(n.orders[0].order_id == "5290947693" && n.orders[0].order_state == "open");
+            CHECK(n.orders[0].buy && n.orders[0].price == 36900.0 && n.orders[0].filled_amount == 1.0);
+        }
+    }
+}
+
+void test_book_snapshot_from_channel() {
+    FeedDecoder decoder;
+    Notification n;
+    const char* grouped =
+        R"({"timestamp":1700000000123,"instrument_name":"BTC-PERPETUAL","change_id":68870124,)"
+        R"("bids":[[36950.5,12340.0]],"asks":[[36951.0,20.0],[36951.5,5.0]]})";
+    for (bool reversed : {false, true}) {
+        std::string frame = reversed ? data_first("book.BTC-PERPETUAL.none.10.100ms", grouped)
+                                     : channel_first("book.BTC-PERPETUAL.none.10.100ms", grouped);
+        CHECK(decoder.decode(frame, n));
+        CHECK(n.kind == Notification::Kind::Book && n.book.snapshot);
+        CHECK(n.book.bids.size() == 1 && n.book.asks.size() == 2);
+    }
+
+    // A raw book types every message; one without a type is not guessed at
+    std::string untyped = R"({"timestamp":1,"instrument_name":"BTC-PERPETUAL","change_id":2,"bids":[],"asks":[]})";
+    CHECK(!decoder.decode(channel_first("book.BTC-PERPETUAL.raw", untyped), n));
+    CHECK(n.kind == Notification::Kind::None);
+
+    std::string snapshot =
+        R"({"type":"snapshot","timestamp":1,"instrument_name":"BTC-PERPETUAL","change_id":2,"bids":[],"asks":[]})";
+    CHECK(decoder.decode(data_first("book.BTC-PERPETUAL.raw", snapshot), n));
+    CHECK(n.kind == Notification::Kind::Book && n.book.snapshot && n.book.prev_change_id == -1);
+}
+
+void test_rejects_missing_data() {
+    FeedDecoder decoder;
+    Notification n;
+    // Without its payload a book frame used to decode as an empty snapshot
+    CHECK(!decoder.decode(R"({"jsonrpc":"2.0","method":"subscription","params":{"channel":"book.BTC-PERPETUAL.raw"}})", n));
+    CHECK(n.kind == Notification::Kind::None);
+    CHECK(!decoder.decode(channel_first("book.BTC-PERPETUAL.raw", "null"), n));
+    CHECK(!decoder.decode(channel_first("trades.BTC-PERPETUAL.raw", "{}"), n));
+    CHECK(!decoder.decode(channel_first("ticker.BTC-PERPETUAL.raw", "[]"), n));
+
+    // Untyped channels keep decoding as Other, payload or not
+    CHECK(decoder.decode(channel_first("deribit_price_index.btc_usd", R"({"price":1})"), n));
+    CHECK(n.kind == Notification::Kind::Other && n.channel == "deribit_price_index.btc_usd");
+    // So does a book channel in neither book format
+    CHECK(decoder.decode(channel_first("book.BTC-PERPETUAL.fast", R"({"type":"change"})"), n));
+    CHECK(n.kind == Notification::Kind::Other);
+}
+
+void test_kind_channels_have_no_instrument() {
+    InstrumentRegistry::instance().intern("BTC-PERPETUAL");
+    FeedDecoder decoder;
+    Notification n;
+    CHECK(decoder.decode(channel_first("trades.future.BTC.raw", kTrades), n));
+    CHECK(n.kind == Notification::Kind::Trades && n.trade_count == 2);
+    CHECK(n.instrument == kNoInstrument);
+    CHECK(decoder.decode(channel_first("user.orders.future.BTC.raw", kOrder), n));
+    CHECK(n.kind == Notification::Kind::UserOrders && n.instrument == kNoInstrument);
+    CHECK(decoder.decode(channel_first("trades.BTC-PERPETUAL.raw", kTrades), n));
+    CHECK(n.instrument == InstrumentRegistry::instance().find("BTC-PERPETUAL"));
+}
+
+void test_rejects_non_notifications() {
+    FeedDecoder decoder;
+    Notification n;
+    CHECK(!decoder.decode(R"({"jsonrpc":"2.0","id":5,"result":["book.BTC-PERPETUAL.raw"]})", n));
+    CHECK(n.kind == Notification::Kind::None);
+    CHECK(!decoder.decode(R"({"jsonrpc":"2.0","method":"heartbeat","params":{"type":"test_request"}})", n));
+    CHECK(!decoder.decode(R"({"jsonrpc":"2.0","method":"subscription","params":{"channel":)", n));
+}
+
+}  // namespace
+
+int main() {
+    test_book_key_order();
+    test_trades_key_order();
+    test_ticker_key_order();
+    test_user_orders_key_order();
+    test_book_snapshot_from_channel();
+    test_rejects_missing_data();
+    test_kind_channels_have_no_instrument();
+    test_rejects_non_notifications();
+    return test_result();
+}
@@ -0,0 +1,60 @@
+#include "../include/instrument_registry.h"
+#include <string>
+#include <vector>
+#include "test_util.h"
+
+namespace {
+
+void test_bulk_intern() {
+    InstrumentRegistry registry;
+    std::vector<std::string> chain;
+    for (int strike = 20000; strike < 120000; strike += 1000) {
+        chain.push_back("BTC-27DEC24-" + std::to_string(strike) + "-C");
+        chain.push_back("BTC-27DEC24-" + std::to_string(strike) + "-P");
+    }
+    registry.intern(chain);
+    CHECK(registry.size() == chain.size());
+    for (size_t i = 0; i < chain.size(); ++i) {
+        CHECK(registry.find(chain[i]) == static_cast<InstrumentId>(i));
+        CHECK(registry.name(static_cast<InstrumentId>(i)) == chain[i]);
+    }
+    CHECK(registry.find("BTC-27DEC24-20500-C") == kNoInstrument);
+
+    // Interning again keeps the ids
+    registry.intern(chain);
+    CHECK(registry.size() == chain.size());
+    CHECK(registry.intern(chain[7]) == 7);
+}
+
+void test_ids_survive_rebuilds() {
+    InstrumentRegistry registry;
+    InstrumentId first = registry.intern("BTC-PERPETUAL");
+    for (int i = 0; i < 200; ++i) {
+        registry.intern("ETH-" + std::to_string(i));
+    }
+    CHECK(registry.find("BTC-PERPETUAL") == first);
+    CHECK(registry.find("ETH-199") == 200);
+    CHECK(registry.size() == 201);
+}
+
+void test_instrument_of() {
+    CHECK(InstrumentRegistry::instrument_of("book.BTC-PERPETUAL.raw") == "BTC-PERPETUAL");
+    CHECK(InstrumentRegistry::instrument_of("book.ETH-PERPETUAL.none.10.100ms") == "ETH-PERPETUAL");
+    CHECK(InstrumentRegistry::instrument_of("ticker.BTC-27DEC24-100000-C.100ms") == "BTC-27DEC24-100000-C");
+    CHECK(InstrumentRegistry::instrument_of("user.orders.ETH-PERPETUAL.raw") == "ETH-PERPETUAL");
+    // Kind and currency channels carry many instruments, not one named "future"
+    CHECK(InstrumentRegistry::instrument_of("trades.future.BTC.raw").empty());
+    CHECK(InstrumentRegistry::instrument_of("trades.option.ETH.100ms").empty());
+    CHECK(InstrumentRegistry::instrument_of("user.orders.future.BTC.raw").empty());
+    CHECK(InstrumentRegistry::instrument_of("user.orders.any.any.raw").empty());
+    CHECK(InstrumentRegistry::instrument_of("user.trades.option_combo.BTC.100ms").empty());
+}
+
+}  // namespace
+
+int main() {
+    test_bulk_intern();
+    test_ids_survive_rebuilds();
+    test_instrument_of();
+    return test_result();
+}
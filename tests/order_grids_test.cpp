@@ -0,0 +1,67 @@
+#include "../include/order_grids.h"
+#include <string>
+#include <string_view>
+#include "../include/rpc_encoder.h"
+#include "test_util.h"
+
+namespace {
+
+OrderGrid btc_perpetual_grid() {
+    return OrderGrid{FixedScale::from_double(0.5), FixedScale::from_double(10.0)};
+}
+
+void test_lookup() {
+    OrderGrids grids;
+    InstrumentId id = InstrumentRegistry::instance().intern("BTC-PERPETUAL");
+    CHECK(!grids.find(id));
+    CHECK(!grids.find(kNoInstrument));
+    grids.set(id, btc_perpetual_grid());
+    std::optional<OrderGrid> grid = grids.find(id);
+    CHECK(grid.has_value());
+    // Recording it again replaces the old grid
+    grids.set(id, OrderGrid{FixedScale::from_double(1.0), FixedScale::from_double(10.0)});
+    CHECK(to_double(grids.find(id)->price(36950.4, true)) == 36950.0);
+}
+
+// Snapping never enlarges an order or moves its limit toward the other side
+void test_conservative_rounding() {
+    OrderGrid grid = btc_perpetual_grid();
+    CHECK(to_double(grid.amount(17)) == 10.0);
+    CHECK(to_double(grid.amount(19.99)) == 10.0);
+    CHECK(to_double(grid.amount(30)) == 30.0);
+    // Below one step gives zero, which the order paths refuse
+    CHECK(grid.amount(9).mantissa == 0);
+
+    CHECK(to_double(grid.price(36950.37, true)) == 36950.0);   // bid down
+    CHECK(to_double(grid.price(36950.37, false)) == 36950.5);  // ask up
+    CHECK(to_double(grid.price(36950.5, true)) == 36950.5);
+    CHECK(to_double(grid.price(36950.5, false)) == 36950.5);
+
+    // Doubles a rounding error away from a grid point count as on it
+    OrderGrid fine{FixedScale::from_double(0.1), FixedScale::from_double(0.1)};
+    CHECK(to_double(fine.price(0.1 + 0.2, false)) == 0.3);
+    CHECK(to_double(fine.price(0.3, true)) == 0.3);
+    CHECK(to_double(fine.amount(0.1 + 0.2)) == 0.3);
+    CHECK(to_double(fine.amount(0.7 - 0.4)) == 0.3);
+}
+
+void test_snapped_order_encoding() {
+    OrderGrid grid = btc_perpetual_grid();
+    RpcEncoder encoder;
+    std::string body(encoder.buy(1, "BTC-PERPETUAL", grid.amount(17), "limit", grid.price(36950.37, true)));
+    CHECK(body.find(R"("amount":10)") != std::string::npos);
+    CHECK(body.find(R"("price":36950})") != std::string::npos);
+
+    body = std::string(encoder.edit(3, "ETH-1234", grid.amount(10), grid.price(0.1 + 0.2, false)));
+    CHECK(body.find(R"("price":0.5)") != std::string::npos);
+    CHECK(body.find(R"("amount":10)") != std::string::npos);
+}
+
+}  // namespace
+
+int main() {
+    test_lookup();
+    test_conservative_rounding();
+    test_snapped_order_encoding();
+    return test_result();
+}
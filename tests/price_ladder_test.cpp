@@ -0,0 +1,161 @@
+#include "../include/price_ladder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+#include "test_util.h"
+
+namespace {
+
+// What sweep() computes, walking the levels one by one
+SweepResult reference_sweep(const PriceLadder& ladder, double amount) {
+    SweepResult result{};
+    ladder.for_each([&](Price price, double size) {
+        double take = std::min(size, amount - result.filled);
+        result.filled += take;
+        result.tick_notional += take * static_cast<double>(price.units);
+        result.worst = price;
+        return result.filled < amount;
+    });
+    return result;
+}
+
+double reference_depth(const PriceLadder& ladder, int64_t ticks) {
+    double depth = 0.0;
+    int64_t best = ladder.best_price().units;
+    ladder.for_each([&](Price price, double size) {
+        if (std::llabs(price.units - best) <= ticks) depth += size;
+        return true;
+    });
+    return depth;
+}
+
+bool close(double a, double b, double relative) {
+    return std::fabs(a - b) <= relative * (1.0 + std::fabs(b));
+}
+
+// Random ladders of varying density against the reference walks, so the
+// chunked SIMD sums are checked across chunk boundaries and ladder ends
+void test_matches_reference_walk() {
+    std::mt19937 rng(3);
+    for (int round = 0; round < 300; ++round) {
+        for (PriceLadder::Side side : {PriceLadder::Side::Bid, PriceLadder::Side::Ask}) {
+            PriceLadder ladder(side, 4096);
+            int density = 1 + static_cast<int>(rng() % 4);
+            int64_t best = 100000;
+            for (int64_t i = 0; i < 3000; ++i) {
+                if (rng() % density == 0) {
+                    ladder.set(Price(side == PriceLadder::Side::Bid ? best - i : best + i), 1 + rng() % 100);
+                }
+            }
+
+            double amount = static_cast<double>(rng() % 200000) * 0.7;
+            SweepResult got = ladder.sweep(amount);
+            SweepResult want = reference_sweep(ladder, amount);
+            CHECK(close(got.filled, want.filled, 1e-9));
+            CHECK(close(got.tick_notional, want.tick_notional, 1e-9));
+            CHECK(got.worst.units == want.worst.units);
+
+            int64_t ticks = static_cast<int64_t>(rng() % 5000);
+            CHECK(close(ladder.depth_within(ticks), reference_depth(ladder, ticks), 1e-9));
+        }
+    }
+}
+
+// Levels as for_each sees them, best first
+std::vector<std::pair<int64_t, double>> levels_of(const PriceLadder& ladder) {
+    std::vector<std::pair<int64_t, double>> levels;
+    ladder.for_each([&](Price price, double size) {
+        levels.emplace_back(price.units, size);
+        return true;
+    });
+    return levels;
+}
+
+// The market moves away from the old best: new levels land beyond the far
+// edge of the window while the old best still rests, then the old levels go
+void test_drift_past_the_far_edge() {
+    PriceLadder asks(PriceLadder::Side::Ask, 4096);
+    asks.set(Price(100000), 1.0);
+    asks.set(Price(105000), 2.0);  // beyond the window anchored on 100000
+    asks.set(Price(110000), 3.0);
+    CHECK(asks.level_count() == 3);
+    asks.set(Price(100000), 0.0);
+    CHECK(asks.best_price().units == 105000 && asks.best_amount() == 2.0);
+    asks.set(Price(105000), 0.0);
+    CHECK(asks.best_price().units == 110000);
+    CHECK(!asks.truncated());
+
+    // A new best far above keeps the deep bids instead of pushing them out
+    PriceLadder bids(PriceLadder::Side::Bid, 4096);
+    bids.set(Price(100000), 1.0);
+    bids.set(Price(99000), 2.0);
+    bids.set(Price(103500), 3.0);
+    bids.set(Price(103500), 0.0);
+    bids.set(Price(100000), 0.0);
+    CHECK(bids.best_price().units == 99000 && bids.best_amount() == 2.0);
+    CHECK(bids.depth_within(1000) == 2.0);
+}
+
+// The mid drifts ten window widths up and back down while levels are set
+// and deleted around it, against a std::map of the same levels
+void test_random_drift_matches_map() {
+    std::mt19937 rng(11);
+    for (PriceLadder::Side side : {PriceLadder::Side::Bid, PriceLadder::Side::Ask}) {
+        PriceLadder ladder(side, 512);
+        std::map<int64_t, double> reference;
+        int64_t mid = 1000000;
+        for (int step = 0; step < 200000; ++step) {
+            if (step % 40 == 0) {
+                mid += step < 100000 ? 1 : -1;
+            }
+            int64_t offset = static_cast<int64_t>(rng() % 1200) - 600;
+            int64_t tick = side == PriceLadder::Side::Bid ? mid - offset : mid + offset;
+            double amount = rng() % 2 == 0 ? 0.0 : static_cast<double>(1 + rng() % 50);
+            ladder.set(Price(tick), amount);
+            if (amount == 0.0) {
+                reference.erase(tick);
+            } else {
+                reference[tick] = amount;
+            }
+        }
+        std::vector<std::pair<int64_t, double>> want(reference.begin(), reference.end());
+        if (side == PriceLadder::Side::Bid) {
+            std::reverse(want.begin(), want.end());
+        }
+        CHECK(levels_of(ladder) == want);
+        CHECK(ladder.level_count() == reference.size());
+        CHECK(!ladder.truncated());
+    }
+}
+
+void test_too_wide_is_reported() {
+    PriceLadder asks(PriceLadder::Side::Ask, 64);
+    asks.set(Price(0), 1.0);
+    asks.set(Price(PriceLadder::kMaxLevels + 10), 1.0);
+    CHECK(asks.truncated());
+    CHECK(asks.level_count() == 1);
+    asks.clear();
+    CHECK(!asks.truncated());
+}
+
+void test_empty_ladder() {
+    PriceLadder ladder(PriceLadder::Side::Ask, 64);
+    SweepResult result = ladder.sweep(10.0);
+    CHECK(result.filled == 0.0);
+    CHECK(ladder.depth_within(10) == 0.0);
+}
+
+}  // namespace
+
+int main() {
+    test_matches_reference_walk();
+    test_drift_past_the_far_edge();
+    test_random_drift_matches_map();
+    test_too_wide_is_reported();
+    test_empty_ladder();
+    return test_result();
+}
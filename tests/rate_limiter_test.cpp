@@ -0,0 +1,74 @@
+#include "../include/rate_limiter.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "test_util.h"
+
+namespace {
+
+using Pool = RateLimiter::Pool;
+using Priority = RateLimiter::Priority;
+
+constexpr RateLimiter::Class kCancel{Pool::MatchingEngine, Priority::Cancel};
+constexpr RateLimiter::Class kEdit{Pool::MatchingEngine, Priority::Edit};
+constexpr RateLimiter::Class kOther{Pool::NonMatchingEngine, Priority::Other};
+
+// Two requests' worth of credits and a slow refill, so the tests can drain it
+constexpr RateLimiter::Bucket kSmall{2000, 1000, 1000, 0};
+
+void test_registered_waiter_outranks_lower_priorities() {
+    RateLimiter limiter(kSmall, RateLimiter::kNonMatchingEngine);
+    limiter.add_waiter(kCancel);
+    CHECK(!limiter.try_acquire(kEdit));
+    CHECK(limiter.try_acquire(kOther));  // other pools are not held back
+
+    CHECK(limiter.try_acquire_waiter(kCancel));
+    CHECK(limiter.try_acquire(kEdit));
+    CHECK(!limiter.try_acquire(kEdit));  // bucket empty
+}
+
+void test_removed_waiter_releases_lower_priorities() {
+    RateLimiter limiter(kSmall, RateLimiter::kNonMatchingEngine);
+    limiter.add_waiter(kCancel);
+    CHECK(!limiter.try_acquire(kEdit));
+    limiter.remove_waiter(kCancel);
+    CHECK(limiter.try_acquire(kEdit));
+}
+
+// A cancel queued by one client gets the next credits ahead of an edit
+// already blocked in acquire() by another client
+void test_queued_cancel_beats_blocked_edit() {
+    RateLimiter limiter(kSmall, RateLimiter::kNonMatchingEngine);
+    CHECK(limiter.try_acquire(kEdit));
+    CHECK(limiter.try_acquire(kEdit));
+
+    std::atomic<bool> edited{false};
+    std::thread editor([&] {
+        limiter.acquire(kEdit);
+        edited = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    limiter.add_waiter(kCancel);
+
+    bool cancelled = false;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (!cancelled && std::chrono::steady_clock::now() < deadline) {
+        cancelled = limiter.try_acquire_waiter(kCancel);
+        if (!cancelled) {
+            CHECK(!edited);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    CHECK(cancelled);
+    editor.join();
+    CHECK(edited);
+}
+
+}  // namespace
+
+int main() {
+    test_registered_waiter_outranks_lower_priorities();
+    test_removed_waiter_releases_lower_priorities();
+    test_queued_cancel_beats_blocked_edit();
+    return test_result();
+}
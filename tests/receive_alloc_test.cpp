@@ -0,0 +1,122 @@
+#include "../include/feed_decoder.h"
+#include <string>
+#include <vector>
+#include "alloc_counter.h"
+#include "test_util.h"
+
+// The receive path must not allocate per message once its buffers have
+// grown. Every global operator new in this binary is counted; after a
+// warm-up pass, repeated decodes of the same frames out of one reused
+// buffer must count zero.
+
+namespace {
+
+// Frames of every typed channel, with instrument names past the
+// small-string buffer and an escaped string that goes through the
+// scanner's scratch buffer
+const std::vector<std::string>& frames() {
+    static const std::vector<std::string> all = {
+        R"({"jsonrpc":"2.0","method":"subscription","params":{"channel":"book.BTC-27DEC24-100000-C.raw","data":{)"
+        R"("type":"snapshot","timestamp":1700000000000,"instrument_name":"BTC-27DEC24-100000-C","change_id":10,)"
+        R"("bids":[["new",0.0125,10.0],["new",0.012,25.5],["new",0.0115,3.0]],"asks":[["new",0.013,4.0]]}}})",
+        R"({"jsonrpc":"2.0","method":"subscription","params":{"channel":"book.BTC-27DEC24-100000-C.raw","data":{)"
+        R"("type":"change","timestamp":1700000000123,"prev_change_id":10,"instrument_name":"BTC-27DEC24-100000-C",)"
+        R"("change_id":11,"bids":[["change",0.0125,12.0],["delete",0.012,0.0]],"asks":[["new",0.0135,1.0]]}}})",
+        R"({"jsonrpc":"2.0","method":"subscription","params":{"channel":"book.ETH-PERPETUAL.none.10.100ms","data":{)"
+        R"("timestamp":1700000000200,"instrument_name":"ETH-PERPETUAL","change_id":5,)"
+        R"("bids":[[2000.5,100.0],[2000.0,50.0]],"asks":[[2001.0,75.0]]}}})",
+        R"({"jsonrpc":"2.0","method":"subscription","params":{"channel":"trades.BTC-PERPETUAL.raw","data":[)"
+        R"({"trade_seq":1,"trade_id":"48079254","timestamp":1590484156350,"price":8950.0,)"
+        R"("instrument_name":"BTC-PERPETUAL","direction":"sell","amount":10.0},)"
+        R"({"trade_seq":2,"trade_id":"48079255","timestamp":1590484156351,"price":8950.5,)"
+        R"("instrument_name":"BTC-PERPETUAL","direction":"buy","amount":20.0}]}})",
+        R"({"jsonrpc":"2.0","method":"subscription","params":{"channel":"ticker.BTC-PERPETUAL.100ms","data":{)"
+        R"("timestamp":1623060194301,"stats":{"volume":2,"low":1,"high":2},"mark_price":36922.42,)"
+        R"("instrument_name":"BTC-PERPETUAL","best_bid_price":36923.0,"best_bid_amount":4800.0,)"
+        R"("best_ask_price":36923.5,"best_ask_amount":320.0}}})",
+        R"({"jsonrpc":"2.0","method":"subscription","params":{"channel":"user.orders.BTC-PERPETUAL.raw","data":{)"
+        R"("price":36900.0,"order_state":"open","order_id":"5290947693","label":"hedge \"leg\" 1",)"
+        R"("last_update_timestamp":1623060194301,"instrument_name":"BTC-PERPETUAL","filled_amount":0.0,)"
+        R"("direction":"buy","average_price":0.0,"amount":10.0}}})",
+        R"({"params":{"data":{"type":"change","timestamp":1,"prev_change_id":11,"change_id":12,)"
+        R"("instrument_name":"BTC-27DEC24-100000-C","bids":[["new",0.011,1.0]],"asks":[]},)"
+        R"("channel":"book.BTC-27DEC24-100000-C.raw"},"method":"subscription","jsonrpc":"2.0"})",
+        R"({"jsonrpc":"2.0","method":"heartbeat","params":{"type":"test_request"}})",
+        R"({"jsonrpc":"2.0","id":42,"result":["book.BTC-PERPETUAL.raw"],"usIn":1,"usOut":2})",
+    };
+    return all;
+}
+
+// A handler that only counts events, for the scanner on its own
+struct CountingHandler {
+    size_t events = 0;
+    bool start_object() { ++events; return true; }
+    bool end_object() { ++events; return true; }
+    bool start_array() { ++events; return true; }
+    bool end_array() { ++events; return true; }
+    bool key(std::string_view) { ++events; return true; }
+    bool string(std::string_view) { ++events; return true; }
+    bool number(std::string_view, bool) { ++events; return true; }
+    bool boolean(bool) { ++events; return true; }
+    bool null() { ++events; return true; }
+};
+
+void test_decoder_steady_state() {
+    // Subscribing interns the instruments, so decoding can resolve their ids
+    InstrumentRegistry::instance().intern(
+        std::vector<std::string>{"BTC-27DEC24-100000-C", "ETH-PERPETUAL", "BTC-PERPETUAL"});
+
+    FeedDecoder decoder;
+    Notification notification;
+    std::string buffer;  // stands in for the connection's read buffer
+    size_t decoded = 0;
+    auto pass = [&] {
+        for (const std::string& frame : frames()) {
+            buffer.assign(frame);
+            decoded += decoder.decode(buffer, notification) ? 1 : 0;
+        }
+    };
+
+    pass();  // grows the notification, the scratch buffer and the read buffer
+    CHECK(decoded == frames().size() - 2);
+
+    size_t before = allocation_count();
+    for (int i = 0; i < 1000; ++i) {
+        pass();
+    }
+    size_t allocations = allocation_count() - before;
+    if (allocations != 0) {
+        std::cerr << allocations << " allocations in 1000 decode passes\n";
+    }
+    CHECK(allocations == 0);
+    CHECK(decoder.decode(frames()[0], notification));
+    CHECK(notification.instrument == InstrumentRegistry::instance().find("BTC-27DEC24-100000-C"));
+}
+
+void test_scanner_steady_state() {
+    JsonScanner scanner;
+    CountingHandler handler;
+    std::string buffer;
+    auto pass = [&] {
+        for (const std::string& frame : frames()) {
+            buffer.assign(frame);
+            scanner.parse(buffer, handler);
+        }
+    };
+
+    pass();
+    size_t before = allocation_count();
+    for (int i = 0; i < 1000; ++i) {
+        pass();
+    }
+    CHECK(allocation_count() == before);
+    CHECK(handler.events > 0);
+}
+
+}  // namespace
+
+int main() {
+    test_decoder_steady_state();
+    test_scanner_steady_state();
+    return test_result();
+}
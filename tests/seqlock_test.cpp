@@ -0,0 +1,80 @@
+#include "../include/order_book.h"
+#include "../include/seqlock.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "test_util.h"
+
+namespace {
+
+// Every field written from the same counter, so a torn copy shows mixed values
+BookSnapshot snapshot_of(int64_t n) {
+    BookSnapshot snapshot;
+    snapshot.valid = true;
+    snapshot.bid_count = snapshot.ask_count = BookSnapshot::kDepth;
+    snapshot.change_id = snapshot.timestamp = n;
+    for (size_t i = 0; i < BookSnapshot::kDepth; ++i) {
+        snapshot.bids[i] = {Price(n), static_cast<double>(n)};
+        snapshot.asks[i] = {Price(n), static_cast<double>(n)};
+    }
+    return snapshot;
+}
+
+bool consistent(const BookSnapshot& snapshot) {
+    bool ok = snapshot.timestamp == snapshot.change_id;
+    for (size_t i = 0; i < BookSnapshot::kDepth; ++i) {
+        ok &= snapshot.bids[i].price.units == snapshot.change_id;
+        ok &= snapshot.asks[i].amount == static_cast<double>(snapshot.change_id);
+    }
+    return ok;
+}
+
+void test_single_thread() {
+    SeqLock<BookSnapshot> lock;
+    CHECK(lock.version() == 0);
+    CHECK(!lock.load().valid);
+    lock.store(snapshot_of(7));
+    CHECK(lock.version() == 1);
+    BookSnapshot out;
+    CHECK(lock.try_load(out));
+    CHECK(out.change_id == 7 && consistent(out));
+}
+
+// Readers racing one writer never see a torn value, nor one going backwards
+void test_no_torn_reads() {
+    constexpr int64_t kStores = 200000;
+    SeqLock<BookSnapshot> lock;
+    lock.store(snapshot_of(0));
+    std::atomic<bool> stop{false};
+    std::atomic<int> bad{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            int64_t last = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                BookSnapshot snapshot = lock.load();
+                if (!consistent(snapshot) || snapshot.change_id < last) {
+                    ++bad;
+                }
+                last = snapshot.change_id;
+            }
+        });
+    }
+    for (int64_t n = 1; n <= kStores; ++n) {
+        lock.store(snapshot_of(n));
+    }
+    stop = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    CHECK(bad == 0);
+    CHECK(lock.load().change_id == kStores);
+}
+
+}  // namespace
+
+int main() {
+    test_single_thread();
+    test_no_torn_reads();
+    return test_result();
+}
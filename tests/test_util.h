@@ -0,0 +1,31 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <iostream>
+
+// Minimal checks for the test executables (no framework dependency).
+// A failed CHECK prints its location and the run carries on; main returns
+// test_result(), which ctest reads as pass or fail.
+
+inline int& test_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond)                                                                   \
+    do {                                                                              \
+        if (!(cond)) {                                                                \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed\n"; \
+            ++test_failures();                                                        \
+        }                                                                             \
+    } while (0)
+
+inline int test_result() {
+    if (test_failures() != 0) {
+        std::cerr << test_failures() << " check(s) failed\n";
+        return 1;
+    }
+    return 0;
+}
+
+#endif